@@ -0,0 +1,326 @@
+/*
+  ==============================================================================
+
+    AudioProfiler.cpp
+    Created: 23 Sep 2022 10:41:27am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "AudioProfiler.h"
+
+namespace
+{
+    //Checked by every scope, kept outside the state so an idle scope never touches it
+    std::atomic<bool> recording{ false };
+
+    //Ring of the calling thread (-1 until its first event) and the name it asked for
+    thread_local int threadRing = -1;
+    thread_local const char* threadName = nullptr;
+}
+
+//==============================================================================
+class AudioProfiler::State : private juce::Thread
+{
+public:
+    //One stage (or an instant event when end is -1), in high resolution ticks
+    struct Event
+    {
+        const char* name;
+        juce::int64 start;
+        juce::int64 end;
+    };
+
+    State() : juce::Thread("Profiler drain")
+    {
+        for (int i = 0; i < maxThreads; ++i)
+        {
+            rings.add(new Ring());
+        }
+    }
+
+    ~State() override
+    {
+        stopThread(1000);
+    }
+
+    //Writer side, any thread
+    void push(const Event& event) noexcept
+    {
+        auto* ring = getRing();
+        if (ring == nullptr)   //More threads than rings
+        {
+            ++numDropped;
+            return;
+        }
+
+        int start1, size1, start2, size2;
+        ring->fifo.prepareToWrite(1, start1, size1, start2, size2);
+        if (size1 == 0)   //The drain is behind, lose the event rather than wait for it
+        {
+            ++numDropped;
+            return;
+        }
+        ring->events[start1] = event;
+        ring->fifo.finishedWrite(1);
+    }
+
+    void nameRing(const char* name) noexcept
+    {
+        if (auto* ring = getRing())
+        {
+            ring->name = name;
+        }
+    }
+
+    //Message thread
+    void startRecording()
+    {
+        stopThread(1000);
+        {
+            const juce::ScopedLock sl(lock);
+            //Whatever is left from before is not part of this recording
+            drain(false);
+            events.clear();
+            events.reserve(65536);
+            numDropped = 0;
+            startTicks = juce::Time::getHighResolutionTicks();
+        }
+        recording = true;
+        startThread();
+    }
+
+    void stopRecording()
+    {
+        recording = false;
+        stopThread(1000);
+
+        const juce::ScopedLock sl(lock);
+        drain(true);
+    }
+
+    bool exportTrace(const juce::File& file)
+    {
+        file.deleteFile();
+        juce::FileOutputStream stream(file);
+        if (stream.failedToOpen())
+        {
+            std::cout << "AudioProfiler::exportTrace could not write " << file.getFullPathName() << std::endl;
+            return false;
+        }
+
+        const juce::ScopedLock sl(lock);
+        double ticksToMicroseconds = 1000000.0 / (double) juce::Time::getHighResolutionTicksPerSecond();
+        int numThreads = juce::jmin(numRings.load(), maxThreads);
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        //Thread names first, the viewer lists the threads in this order
+        for (int i = 0; i < numThreads; ++i)
+        {
+            const char* name = rings[i]->name;
+            stream << (i > 0 ? ",\n" : "")
+                   << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (i + 1)
+                   << ",\"args\":{\"name\":\"" << (name != nullptr ? juce::String(name) : "Thread " + juce::String(i + 1)) << "\"}}";
+        }
+
+        for (auto& recorded : events)
+        {
+            auto& event = recorded.event;
+            stream << ",\n{\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << (recorded.thread + 1)
+                   << ",\"ts\":" << juce::String((double) (event.start - startTicks) * ticksToMicroseconds, 3);
+
+            if (event.end < 0)
+            {
+                stream << ",\"ph\":\"i\",\"s\":\"t\"}";
+            }
+            else
+            {
+                stream << ",\"ph\":\"X\",\"dur\":" << juce::String((double) (event.end - event.start) * ticksToMicroseconds, 3) << "}";
+            }
+        }
+
+        stream << "\n]}\n";
+        stream.flush();
+        return stream.getStatus().wasOk();
+    }
+
+    int getNumEvents()
+    {
+        const juce::ScopedLock sl(lock);
+        return (int) events.size();
+    }
+
+    int getNumDropped() const
+    {
+        return numDropped;
+    }
+
+private:
+    //Single producer (its thread), single consumer (the drain)
+    struct Ring
+    {
+        juce::AbstractFifo fifo{ ringSize };
+        Event events[ringSize];
+        std::atomic<const char*> name{ nullptr };
+    };
+
+    struct RecordedEvent
+    {
+        Event event;
+        int thread;
+    };
+
+    Ring* getRing() noexcept
+    {
+        if (threadRing < 0)   //First event of this thread, claim a ring
+        {
+            int index = numRings++;
+            threadRing = juce::jmin(index, maxThreads);
+
+            if (threadRing < maxThreads)
+            {
+                rings[threadRing]->name = threadName != nullptr ? threadName
+                                          : juce::MessageManager::existsAndIsCurrentThread() ? "Message"
+                                          : nullptr;
+            }
+        }
+
+        return threadRing < maxThreads ? rings.getUnchecked(threadRing) : nullptr;
+    }
+
+    //Move what the rings hold into the recording (under lock)
+    void drain(bool keep)
+    {
+        int numThreads = juce::jmin(numRings.load(), maxThreads);
+        for (int i = 0; i < numThreads; ++i)
+        {
+            auto& ring = *rings.getUnchecked(i);
+            int start1, size1, start2, size2;
+            ring.fifo.prepareToRead(ring.fifo.getNumReady(), start1, size1, start2, size2);
+
+            for (int j = 0; keep && j < size1 + size2; ++j)
+            {
+                auto& event = ring.events[j < size1 ? start1 + j : start2 + j - size1];
+                if (event.start < startTicks)   //Began before this recording
+                {
+                    continue;
+                }
+                if ((int) events.size() >= maxEvents)
+                {
+                    ++numDropped;
+                    continue;
+                }
+                events.push_back({ event, i });
+            }
+
+            ring.fifo.finishedRead(size1 + size2);
+        }
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            {
+                const juce::ScopedLock sl(lock);
+                drain(true);
+            }
+            wait(10);
+        }
+    }
+
+    juce::OwnedArray<Ring> rings;
+    std::atomic<int> numRings{ 0 };
+    std::atomic<int> numDropped{ 0 };
+
+    juce::CriticalSection lock;
+    std::vector<RecordedEvent> events;
+    juce::int64 startTicks = 0;
+};
+
+//==============================================================================
+AudioProfiler::Scope::Scope(const char* _name) noexcept : name(_name)
+{
+    if (recording.load(std::memory_order_relaxed))
+    {
+        startTicks = juce::Time::getHighResolutionTicks();
+    }
+}
+
+AudioProfiler::Scope::~Scope() noexcept
+{
+    if (startTicks != 0)
+    {
+        record(name, startTicks, juce::Time::getHighResolutionTicks());
+    }
+}
+
+//==============================================================================
+AudioProfiler::State& AudioProfiler::getState()
+{
+    //Created by the first start(), long before any scope records into it
+    static State state;
+    return state;
+}
+
+void AudioProfiler::start()
+{
+    getState().startRecording();
+}
+
+void AudioProfiler::stop()
+{
+    if (isRecording())
+    {
+        getState().stopRecording();
+    }
+}
+
+bool AudioProfiler::isRecording() noexcept
+{
+    return recording.load(std::memory_order_relaxed);
+}
+
+void AudioProfiler::nameThread(const char* name) noexcept
+{
+    if (threadName == name)
+    {
+        return;
+    }
+
+    threadName = name;
+    if (threadRing >= 0)   //Already has a ring, so the state exists
+    {
+        getState().nameRing(name);
+    }
+}
+
+void AudioProfiler::mark(const char* name) noexcept
+{
+    if (isRecording())
+    {
+        record(name, juce::Time::getHighResolutionTicks(), -1);
+    }
+}
+
+bool AudioProfiler::exportTrace(const juce::File& file)
+{
+    return getState().exportTrace(file);
+}
+
+int AudioProfiler::getNumEvents()
+{
+    return getState().getNumEvents();
+}
+
+int AudioProfiler::getNumDropped()
+{
+    return getState().getNumDropped();
+}
+
+void AudioProfiler::record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept
+{
+    getState().push({ name, startTicks, endTicks });
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    AudioProfiler.h
+    Created: 23 Sep 2022 10:41:27am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//Set OTODESKS_PROFILING to 0 in the project defines to compile every profiler scope out
+#ifndef OTODESKS_PROFILING
+ #define OTODESKS_PROFILING 1
+#endif
+
+#if OTODESKS_PROFILING
+ //Time the rest of the enclosing block as a stage called name (a string literal)
+ #define OTODESKS_PROFILE_SCOPE(name) AudioProfiler::Scope JUCE_JOIN_MACRO (profileScope, __LINE__) (name)
+#else
+ #define OTODESKS_PROFILE_SCOPE(name)
+#endif
+
+//==============================================================================
+/*
+    Records how long each stage of the audio callback (and of the message and
+    loader threads around it) takes, and writes it out as a Chrome trace
+    (chrome://tracing or https://ui.perfetto.dev).
+
+    Every thread that records gets its own single-producer ring, claimed once
+    with an atomic counter, so a scope costs two clock reads and a FIFO write
+    and never locks or allocates. A background thread drains the rings into
+    the recording. When nothing is recording a scope is a single atomic load.
+
+    Thread and stage names are string literals, only their pointers are stored.
+*/
+class AudioProfiler
+{
+public:
+    //Times its own lifetime (use OTODESKS_PROFILE_SCOPE)
+    class Scope
+    {
+        public:
+            explicit Scope(const char* _name) noexcept;
+            ~Scope() noexcept;
+
+        private:
+            const char* name;
+            juce::int64 startTicks = 0;
+
+            JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+    //Start a new recording (drops the previous one) and stop it (message thread)
+    static void start();
+    static void stop();
+    static bool isRecording() noexcept;
+
+    //Name the calling thread in the trace ("Audio", "Track loader"...)
+    static void nameThread(const char* name) noexcept;
+    //Record an instant event on the calling thread (an underrun, a late block...)
+    static void mark(const char* name) noexcept;
+
+    //Write the recording as Chrome trace JSON, returns false if the file could not be written
+    static bool exportTrace(const juce::File& file);
+
+    //Number of events recorded so far, and the number lost to full rings or a full recording
+    static int getNumEvents();
+    static int getNumDropped();
+
+    //Size of the ring of each thread, number of threads that can record, and the longest recording (in events)
+    static constexpr int ringSize = 4096;
+    static constexpr int maxThreads = 64;
+    static constexpr int maxEvents = 2000000;
+
+private:
+    class State;
+    static State& getState();
+    static void record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+};
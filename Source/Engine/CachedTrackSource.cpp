@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    CachedTrackSource.cpp
+    Created: 8 Sep 2022 5:02:40pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "CachedTrackSource.h"
+
+CachedTrackSource::CachedTrackSource(DecodedTrack::Ptr _track) : track(_track)
+{
+}
+
+CachedTrackSource::~CachedTrackSource()
+{
+}
+
+//==============================================================================
+void CachedTrackSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+}
+
+void CachedTrackSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto& samples = track->samples;
+    auto length = (juce::int64) samples.getNumSamples();
+    int numChannels = bufferToFill.buffer->getNumChannels();
+
+    int done = 0;
+    while (done < bufferToFill.numSamples)
+    {
+        if (looping && length > 0)
+        {
+            position %= length;
+        }
+
+        //Past the end (not looping), the rest of the block is silent
+        if (position < 0 || position >= length)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + done, bufferToFill.numSamples - done);
+            position += bufferToFill.numSamples - done;
+            break;
+        }
+
+        int numToCopy = (int) juce::jmin((juce::int64) (bufferToFill.numSamples - done), length - position);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            //Mono tracks are copied to both channels
+            int srcCh = juce::jmin(ch, samples.getNumChannels() - 1);
+            bufferToFill.buffer->copyFrom(ch, bufferToFill.startSample + done, samples, srcCh, (int) position, numToCopy);
+        }
+
+        done += numToCopy;
+        position += numToCopy;
+    }
+}
+
+void CachedTrackSource::releaseResources()
+{
+}
+
+//==============================================================================
+void CachedTrackSource::setNextReadPosition(juce::int64 newPosition)
+{
+    position = newPosition;
+}
+
+juce::int64 CachedTrackSource::getNextReadPosition() const
+{
+    auto length = (juce::int64) track->samples.getNumSamples();
+    return looping && length > 0 ? position % length : position;
+}
+
+juce::int64 CachedTrackSource::getTotalLength() const
+{
+    return track->samples.getNumSamples();
+}
+
+bool CachedTrackSource::isLooping() const
+{
+    return looping;
+}
+
+void CachedTrackSource::setLooping(bool shouldLoop)
+{
+    looping = shouldLoop;
+}
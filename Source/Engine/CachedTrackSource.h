@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    CachedTrackSource.h
+    Created: 8 Sep 2022 5:02:40pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DecodedTrackCache.h"
+
+//==============================================================================
+/*
+    Plays a track straight out of the decoded track cache (no disk, no decoder).
+*/
+class CachedTrackSource : public juce::PositionableAudioSource
+{
+public:
+    CachedTrackSource(DecodedTrack::Ptr _track);
+    ~CachedTrackSource() override;
+
+    //Virtual pure functions from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //Virtual pure functions from PositionableAudioSource
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+private:
+    DecodedTrack::Ptr track;
+
+    juce::int64 position = 0;
+    std::atomic<bool> looping{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedTrackSource)
+};
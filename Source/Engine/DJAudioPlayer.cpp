@@ -0,0 +1,725 @@
+/*
+  ==============================================================================
+
+    DJAudioPlayer.cpp
+    Created: 18 Jul 2022 5:42:56pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "DJAudioPlayer.h"
+
+DJAudioPlayer::DJAudioPlayer(juce::AudioFormatManager& _formatManager,
+                             juce::TimeSliceThread& _readAheadThread,
+                             DecodedTrackCache& _trackCache) : formatManager(_formatManager),
+                                                               readAheadThread(_readAheadThread),
+                                                               trackCache(_trackCache)
+{
+    //Transport events are picked up on the message thread
+    startTimer(10);
+}
+
+DJAudioPlayer::~DJAudioPlayer()
+{
+    stopTimer();
+
+    //Cancelled under the source lock, so a load finishing on a loader thread can no longer install itself or post an update
+    cancelLoad();
+    {
+        const juce::ScopedLock sl(sourceLock);
+        nextLoader.cancelPendingLoads();
+        pendingNextLoadId = 0;
+    }
+    cancelPendingUpdate();
+}
+
+//==============================================================================
+void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    transport.prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    keyLock.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    keyLockDry.setSize(2, juce::jmax(1, samplesPerBlockExpected));
+    keyLockActive = false;
+    keyLockWarming = false;
+
+    eq.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    samRate = sampleRate;
+
+    //Ramp lengths: short enough to feel immediate, long enough to kill zipper noise
+    gainSmoothed.reset(sampleRate, 0.02);
+    speedSmoothed.reset(sampleRate, 0.05);
+
+    gainSmoothed.setCurrentAndTargetValue(targetGain);
+    speedSmoothed.setCurrentAndTargetValue(juce::jmax(minSpeed, targetSpeed.load()));
+}
+
+void DJAudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    OTODESKS_PROFILE_SCOPE("DJAudioPlayer::getNextAudioBlock");
+
+    //Pick up the latest values from the GUI once per block, never waiting on it
+    gainSmoothed.setTargetValue(targetGain);
+    speedSmoothed.setTargetValue(juce::jmax(minSpeed, targetSpeed.load()));
+
+    auto* buffer = bufferToFill.buffer;
+    int numChannels = juce::jmin(buffer->getNumChannels(), 2);
+
+    //The transport follows the speed sample by sample (file rate and speed in one conversion)
+    transport.render(*buffer, bufferToFill.startSample, bufferToFill.numSamples, speedSmoothed);
+
+    //Key lock takes the pitch back to the original, at the speed the transport ended the block on
+    bool lockKey = keyLockEnabled;
+    if (!lockKey)
+    {
+        keyLockWarming = false;
+    }
+    if (lockKey || keyLockActive)
+    {
+        OTODESKS_PROFILE_SCOPE("DJAudioPlayer::keyLock");
+        auto startTicks = juce::Time::getHighResolutionTicks();
+
+        //Switched on: its history starts empty, so it is fed while the straight output plays on, and faded in once
+        //every grain reads from what it was fed (twice its latency), not from the silence before
+        if (lockKey && !keyLockActive && !keyLockWarming)
+        {
+            keyLock.reset();
+            keyLockWarmUp = 2 * keyLock.getLatencyInSamples();
+            keyLockWarming = true;
+        }
+        bool warmingUp = keyLockWarming && keyLockWarmUp > 0;
+        //Switching on or off: crossfade between the straight and the corrected output over this block
+        bool switching = lockKey != keyLockActive && !warmingUp;
+
+        if (!warmingUp && !switching)
+        {
+            keyLock.process(*buffer, bufferToFill.startSample, bufferToFill.numSamples, speedSmoothed.getCurrentValue());
+        }
+        else
+        {
+            //The straight output is kept in keyLockDry, a piece of the block at a time (a block can be longer than expected)
+            float wetStart = lockKey ? 0.0f : 1.0f;
+            int numSamples = bufferToFill.numSamples;
+            for (int done = 0; done < numSamples;)
+            {
+                int start = bufferToFill.startSample + done;
+                int numToDo = juce::jmin(keyLockDry.getNumSamples(), numSamples - done);
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    keyLockDry.copyFrom(ch, 0, *buffer, ch, start, numToDo);
+                }
+
+                keyLock.process(*buffer, start, numToDo, speedSmoothed.getCurrentValue());
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    if (warmingUp)
+                    {
+                        buffer->copyFrom(ch, start, keyLockDry, ch, 0, numToDo);
+                    }
+                    else
+                    {
+                        float wetFrom = wetStart + (1.0f - 2.0f * wetStart) * (float) done / (float) numSamples;
+                        float wetTo = wetStart + (1.0f - 2.0f * wetStart) * (float) (done + numToDo) / (float) numSamples;
+                        buffer->applyGainRamp(ch, start, numToDo, wetFrom, wetTo);
+                        buffer->addFromWithRamp(ch, start, keyLockDry.getReadPointer(ch), numToDo, 1.0f - wetFrom, 1.0f - wetTo);
+                    }
+                }
+                done += numToDo;
+            }
+        }
+
+        if (warmingUp)
+        {
+            keyLockWarmUp -= bufferToFill.numSamples;
+        }
+        else
+        {
+            keyLockActive = lockKey;
+            keyLockWarming = false;
+        }
+
+        //Publish the cost as a share of the block's real time (smoothed over a few blocks)
+        double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        double load = seconds * samRate / juce::jmax(1, bufferToFill.numSamples);
+        keyLockLoad = lockKey ? 0.9 * keyLockLoad + 0.1 * load : 0.0;
+    }
+
+    //Isolator and Pass (each skipped while it has nothing to do)
+    {
+        OTODESKS_PROFILE_SCOPE("DJAudioPlayer::eq");
+        eq.process(*buffer, bufferToFill.startSample, bufferToFill.numSamples);
+    }
+
+    //Gain, per sample while it is moving
+    OTODESKS_PROFILE_SCOPE("DJAudioPlayer::gain");
+    if (gainSmoothed.isSmoothing())
+    {
+        for (int i = 0; i < bufferToFill.numSamples; ++i)
+        {
+            float gain = gainSmoothed.getNextValue();
+            for (int ch = 0; ch < buffer->getNumChannels(); ++ch)
+            {
+                buffer->getWritePointer(ch, bufferToFill.startSample)[i] *= gain;
+            }
+        }
+    }
+    else
+    {
+        buffer->applyGain(bufferToFill.startSample, bufferToFill.numSamples, gainSmoothed.getTargetValue());
+    }
+}
+
+void DJAudioPlayer::releaseResources()
+{
+    transport.releaseResources();
+}
+
+void DJAudioPlayer::loadURL(juce::URL audioURL, bool looping)
+{
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    //Hand the file over to the loader thread, the current track keeps playing until the new one is ready
+    {
+        const juce::ScopedLock sl(sourceLock);
+        startWhenLoaded = false;
+        pendingLoadId = loader.requestLoad(audioURL, looping);
+    }
+
+    //Make sure the next load of this track comes from memory
+    trackCache.prefetch(audioURL);
+
+    //Keep track of the worst time the calling (message) thread has been blocked by a load
+    double blockMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    if (blockMs > maxLoadBlockMs)
+    {
+        maxLoadBlockMs = blockMs;
+    }
+}
+
+void DJAudioPlayer::prefetch(const juce::URL& audioURL)
+{
+    trackCache.prefetch(audioURL);
+}
+
+void DJAudioPlayer::cancelLoad()
+{
+    const juce::ScopedLock sl(sourceLock);
+    loader.cancelPendingLoads();
+    pendingLoadId = 0;
+    startWhenLoaded = false;
+}
+
+bool DJAudioPlayer::isLoading() const
+{
+    const juce::ScopedLock sl(sourceLock);
+    return pendingLoadId != 0;
+}
+
+void DJAudioPlayer::preloadNext(const juce::URL& audioURL)
+{
+    {
+        const juce::ScopedLock sl(sourceLock);
+        if (audioURL == nextURL)   //Already there (or on its way)
+        {
+            return;
+        }
+        nextURL = audioURL;
+        pendingNextLoadId = nextLoader.requestLoad(audioURL, false);
+    }
+
+    trackCache.prefetch(audioURL);
+}
+
+void DJAudioPlayer::clearNext()
+{
+    {
+        const juce::ScopedLock sl(sourceLock);
+        nextLoader.cancelPendingLoads();
+        pendingNextLoadId = 0;
+        nextURL = juce::URL();
+    }
+
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::dropNext;
+    transport.pushCommand(command);
+}
+
+void DJAudioPlayer::setOverlap(double seconds)
+{
+    transport.setOverlap(seconds);
+}
+
+void DJAudioPlayer::setResamplingQuality(ResamplingKernel::Quality quality)
+{
+    transport.setQuality(quality);
+}
+
+ResamplingKernel::Quality DJAudioPlayer::getResamplingQuality() const
+{
+    return transport.getQuality();
+}
+
+double DJAudioPlayer::getMaxLoadBlockMs() const
+{
+    return maxLoadBlockMs;
+}
+
+void DJAudioPlayer::setReadAheadSize(int numSamples)
+{
+    readAheadSize = juce::jmax(0, numSamples);
+}
+
+int DJAudioPlayer::getReadAheadSize() const
+{
+    return readAheadSize;
+}
+
+int DJAudioPlayer::getNumUnderruns() const
+{
+    return numUnderruns;
+}
+
+void DJAudioPlayer::resetUnderruns()
+{
+    numUnderruns = 0;
+}
+
+void DJAudioPlayer::addListener(Listener* listener)
+{
+    listeners.add(listener);
+}
+
+void DJAudioPlayer::removeListener(Listener* listener)
+{
+    listeners.remove(listener);
+}
+
+void DJAudioPlayer::installLoadedTrack(TrackLoader::Result& result)
+{
+    {
+        //Drop the result if the load was cancelled or superseded in the meantime
+        const juce::ScopedLock sl(sourceLock);
+        if (result.loadId != pendingLoadId)
+        {
+            return;
+        }
+    }
+
+    if (result.source == nullptr)   //Bad file, keep the current track
+    {
+        std::cout << "DJAudioPlayer::loadURL Something went wrong loading the file " << std::endl;
+    }
+    bool loaded = result.source != nullptr;
+    std::unique_ptr<DeckTransport::Track> track;
+
+    if (loaded)
+    {
+        track = makeTrack(result);
+    }
+
+    {
+        const juce::ScopedLock sl(sourceLock);
+        if (result.loadId != pendingLoadId)   //Superseded while it was being prepared
+        {
+            return;
+        }
+        pendingLoadId = 0;
+
+        if (loaded)
+        {
+            //Play was pressed while the track was still opening
+            track->startPlaying = startWhenLoaded;
+            trackLength = (double) track->length / track->sampleRate;
+
+            //The audio thread swaps it in at the start of its next block
+            transport.setLooping(result.looping);
+            transport.setTrack(std::move(track));
+        }
+        startWhenLoaded = false;
+
+        readyURL = result.url;
+        readyLoaded = loaded;
+
+        //Posted under the lock, so the destructor (which cancels under it) never misses it
+        triggerAsyncUpdate();
+    }
+}
+
+void DJAudioPlayer::installNextTrack(TrackLoader::Result& result)
+{
+    {
+        const juce::ScopedLock sl(sourceLock);
+        if (result.loadId != pendingNextLoadId)
+        {
+            return;
+        }
+    }
+
+    if (result.source == nullptr)   //Bad file, autoplay will stop at the end of the current track
+    {
+        std::cout << "DJAudioPlayer::preloadNext Something went wrong loading the file " << std::endl;
+        return;
+    }
+
+    //Opened and pre-rolled here, the audio thread only has to start reading it
+    auto track = makeTrack(result);
+
+    const juce::ScopedLock sl(sourceLock);
+    if (result.loadId == pendingNextLoadId)
+    {
+        pendingNextLoadId = 0;
+        nextTrackLength = (double) track->length / track->sampleRate;
+        transport.setNextTrack(std::move(track));
+    }
+}
+
+std::unique_ptr<DeckTransport::Track> DJAudioPlayer::makeTrack(TrackLoader::Result& result)
+{
+    std::unique_ptr<DeckTransport::Track> track(new DeckTransport::Track());
+
+    //The transport does the looping itself, the source is only ever read forward inside the track
+    result.source->setLooping(false);
+    track->length = result.source->getTotalLength();
+    track->sampleRate = result.sampleRate;
+    track->inMemory = result.fromCache;
+
+    //Put the read-ahead buffer in front of the file so the audio thread never decodes from disk
+    //(tracks from the cache are already in memory)
+    if (readAheadSize > 0 && !result.fromCache)
+    {
+        track->source.reset(new ReadAheadSource(result.source.release(), readAheadThread, readAheadSize, numUnderruns));
+    }
+    else
+    {
+        track->source = std::move(result.source);
+    }
+
+    //Prepared here on the loader thread (prefilling the read-ahead buffer), never on the audio thread
+    transport.prepareTrack(*track);
+    return track;
+}
+
+void DJAudioPlayer::handleAsyncUpdate()
+{
+    OTODESKS_PROFILE_SCOPE("DJAudioPlayer::handleAsyncUpdate");
+    juce::URL audioURL;
+    bool loaded;
+    {
+        const juce::ScopedLock sl(sourceLock);
+        audioURL = readyURL;
+        loaded = readyLoaded;
+    }
+
+    listeners.call([this, &audioURL, loaded](Listener& l) { l.trackReady(this, audioURL, loaded); });
+}
+
+void DJAudioPlayer::timerCallback()
+{
+    dispatchTransportEvents();
+}
+
+void DJAudioPlayer::dispatchTransportEvents()
+{
+    OTODESKS_PROFILE_SCOPE("DJAudioPlayer::dispatchTransportEvents");
+    DeckTransport::Event event;
+    while (transport.popEvent(event))
+    {
+        if (event.type == DeckTransport::Event::trackAdvanced)   //The preloaded track is now the current one
+        {
+            juce::URL audioURL;
+            {
+                const juce::ScopedLock sl(sourceLock);
+                audioURL = nextURL;
+                trackLength = nextTrackLength;
+                nextURL = juce::URL();
+            }
+
+            listeners.call([this, &audioURL](Listener& l) { l.trackReady(this, audioURL, true); });
+        }
+
+        listeners.call([this, &event](Listener& l) { l.transportEvent(this, event); });
+    }
+
+    //Free the tracks the audio thread has swapped out
+    transport.collectGarbage();
+}
+
+void DJAudioPlayer::setGain(double gain)
+{
+    //Gain has to be between 0.0 and 1.0
+    if (gain < 0 || gain > 1.0)
+    {
+        std::cout << "DJAudioPlayer::setGain gain should be between 0 and 1." << std::endl;
+    }
+    else
+    {
+        //Picked up (and smoothed) by the audio thread on its next block
+        targetGain = (float) gain;
+    }
+}
+
+void DJAudioPlayer::setKeyLock(bool shouldLock)
+{
+    keyLockEnabled = shouldLock;
+}
+
+bool DJAudioPlayer::isKeyLocked() const
+{
+    return keyLockEnabled;
+}
+
+double DJAudioPlayer::getKeyLockLatency() const
+{
+    return keyLock.getLatencyInSamples() / samRate;
+}
+
+double DJAudioPlayer::getKeyLockLoad() const
+{
+    return keyLockLoad;
+}
+
+void DJAudioPlayer::setSpeed(double ratio)
+{
+    //Ratio has to be between 0 and 100
+    if (ratio < 0 || ratio > 100.0)
+    {
+        std::cout << "DJAudioPlayer::setSpeed ratio should be between 0 and 100." << std::endl;
+    }
+    else
+    {
+        //Picked up (and smoothed) by the audio thread on its next block
+        targetSpeed = (float) ratio;
+    }
+}
+
+void DJAudioPlayer::setPosition(double posInSecs)
+{
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::jump;
+    command.position = posInSecs;
+    transport.pushCommand(command);
+}
+
+void DJAudioPlayer::setPositionRelative(double pos)
+{
+    //Position has to be between 0 and 1.0
+    if (pos < 0 || pos > 1.0)
+    {
+        std::cout << "DJAudioPlayer::setPositionRelative pos should be between 0 and 1." << std::endl;
+    }
+    else
+    {
+        double posInSecs = trackLength * pos;
+        setPosition(posInSecs);
+    }
+}
+
+void DJAudioPlayer::setLooping(bool looping)
+{
+    transport.setLooping(looping);
+}
+
+void DJAudioPlayer::setCuePoint(double posInSecs)
+{
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::setCue;
+    command.position = posInSecs;
+    transport.pushCommand(command);
+}
+
+void DJAudioPlayer::cue()
+{
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::cue;
+    transport.pushCommand(command);
+}
+
+void DJAudioPlayer::loopIn()
+{
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::loopIn;
+    transport.pushCommand(command);
+}
+
+void DJAudioPlayer::loopOut()
+{
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::loopOut;
+    transport.pushCommand(command);
+}
+
+void DJAudioPlayer::loopBeats(double beats)
+{
+    //Beats have to be between 1/4 and 32
+    if (beats < 0.25 || beats > 32)
+    {
+        std::cout << "DJAudioPlayer::loopBeats beats should be between 1/4 and 32." << std::endl;
+        return;
+    }
+
+    //Length in secs of the track, the speed does not change it
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::loopLength;
+    command.position = beats * 60.0 / trackBPM;
+    transport.pushCommand(command);
+}
+
+void DJAudioPlayer::reloop()
+{
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::reloop;
+    transport.pushCommand(command);
+}
+
+void DJAudioPlayer::exitLoop()
+{
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::exitLoop;
+    transport.pushCommand(command);
+}
+
+void DJAudioPlayer::setBPM(double bpm)
+{
+    //BPM has to be between 20 and 300
+    if (bpm < 20 || bpm > 300)
+    {
+        std::cout << "DJAudioPlayer::setBPM bpm should be between 20 and 300." << std::endl;
+    }
+    else
+    {
+        trackBPM = bpm;
+    }
+}
+
+double DJAudioPlayer::getBPM() const
+{
+    return trackBPM;
+}
+
+double DJAudioPlayer::getLoopInSeconds() const
+{
+    return transport.getLoopInSeconds();
+}
+
+double DJAudioPlayer::getLoopOutSeconds() const
+{
+    return transport.getLoopOutSeconds();
+}
+
+bool DJAudioPlayer::isInLoop() const
+{
+    return transport.isInLoop();
+}
+
+void DJAudioPlayer::scheduleCommand(const DeckTransport::Command& command)
+{
+    if (!transport.pushCommand(command))
+    {
+        std::cout << "DJAudioPlayer::scheduleCommand command queue is full." << std::endl;
+    }
+}
+
+juce::int64 DJAudioPlayer::getRenderPosition() const
+{
+    return transport.getRenderPosition();
+}
+
+void DJAudioPlayer::setPass(double cutOff, double Q, bool lowPass, bool highPass, bool bandPass)
+{
+    //Pass filter, swept (and smoothed) by the audio thread
+    auto type = lowPass ? DeckEQ::lowPassFilter
+              : highPass ? DeckEQ::highPassFilter
+              : bandPass ? DeckEQ::bandPassFilter
+              : DeckEQ::noFilter;
+    eq.setFilter(type, (float) cutOff, (float) Q);
+}
+
+void DJAudioPlayer::setEQ(double low, double mid, double high)
+{
+    //Each band has to be between 0 (killed) and 2
+    if (low < 0 || low > DeckEQ::maxBandGain || mid < 0 || mid > DeckEQ::maxBandGain || high < 0 || high > DeckEQ::maxBandGain)
+    {
+        std::cout << "DJAudioPlayer::setEQ band gains should be between 0 and 2." << std::endl;
+    }
+    else
+    {
+        //Picked up (and smoothed) by the audio thread on its next block
+        eq.setBandGains((float) low, (float) mid, (float) high);
+    }
+}
+
+void DJAudioPlayer::play()
+{
+    {
+        //If the track is still opening, start it as soon as it has been swapped in
+        const juce::ScopedLock sl(sourceLock);
+        if (pendingLoadId != 0)
+        {
+            startWhenLoaded = true;
+            return;
+        }
+    }
+
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::play;
+    transport.pushCommand(command);
+    std::cout << "Play button was clicked" << std::endl;
+}
+
+void DJAudioPlayer::stop()
+{
+    {
+        const juce::ScopedLock sl(sourceLock);
+        startWhenLoaded = false;
+    }
+
+    DeckTransport::Command command;
+    command.type = DeckTransport::Command::stop;
+    transport.pushCommand(command);
+    std::cout << "Stop button was clicked" << std::endl;
+}
+
+bool DJAudioPlayer::checkStreamFinished()
+{
+    if (transport.hasStreamFinished())
+    {
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+void DJAudioPlayer::replay()
+{
+    if (transport.hasStreamFinished())
+    {
+        //Both run at the start of the same block
+        setPosition(0);
+        play();
+    }
+}
+
+double DJAudioPlayer::getPositionRelative()
+{
+    double length = transport.getLengthInSeconds();
+    if (length <= 0)
+    {
+        return 0;
+    }
+    return transport.getPositionInSeconds() / length;
+}
+
+double DJAudioPlayer::getPositionInSeconds() const
+{
+    return transport.getPositionInSeconds();
+}
+
+double DJAudioPlayer::getLengthInSeconds() const
+{
+    return trackLength;
+}
+
@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+
+    DJAudioPlayer.h
+    Created: 18 Jul 2022 5:42:56pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackLoader.h"
+#include "ReadAheadSource.h"
+#include "DecodedTrackCache.h"
+#include "DeckTransport.h"
+#include "KeyLock.h"
+#include "DeckEQ.h"
+
+class DJAudioPlayer : public juce::AudioSource,
+                      private juce::AsyncUpdater,
+                      private juce::Timer
+{
+    public:
+        //Receives deck notifications on the message thread
+        class Listener
+        {
+            public:
+                virtual ~Listener() = default;
+
+                //Called once a requested track has been swapped into the transport (or failed to open),
+                //and when the preloaded next track takes over
+                virtual void trackReady(DJAudioPlayer* player, const juce::URL& audioURL, bool loaded) = 0;
+                //Called for every transport event (end of stream, loop, cue point...), in the order they happened
+                virtual void transportEvent(DJAudioPlayer* player, const DeckTransport::Event& event) {}
+        };
+
+        DJAudioPlayer(juce::AudioFormatManager& _formatManager,
+                      juce::TimeSliceThread& _readAheadThread,
+                      DecodedTrackCache& _trackCache);
+        ~DJAudioPlayer();
+
+        //==============================================================================
+        //Virtual pure functions from AudioSource
+        void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+        void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+        void releaseResources() override;
+
+        //Load URL of a chosen track (opened in the background, listeners are told when it is ready)
+        void loadURL(juce::URL audioURL, bool looping);
+        //Decode a track into the shared track cache in the background (for decked tracks)
+        void prefetch(const juce::URL& audioURL);
+        //Cancel a load that has not finished yet
+        void cancelLoad();
+        //Bool function to check if a track is still being opened
+        bool isLoading() const;
+
+        //Open and pre-roll the track that follows the current one, it takes over with no gap when the current one ends
+        void preloadNext(const juce::URL& audioURL);
+        //Forget the next track (the current one stops at its end again)
+        void clearNext();
+        //Length (in secs) of the equal-power overlap between the current and the next track, 0 is gapless
+        void setOverlap(double seconds);
+        //Longest time (in ms) that loadURL has blocked the calling thread
+        double getMaxLoadBlockMs() const;
+
+        //Interpolation used to play the track at the device rate and the deck speed (from the next block)
+        void setResamplingQuality(ResamplingKernel::Quality quality);
+        ResamplingKernel::Quality getResamplingQuality() const;
+
+        //Set how many samples are read ahead on the disk thread (0 reads straight from the file), used from the next load
+        void setReadAheadSize(int numSamples);
+        int getReadAheadSize() const;
+        //Number of blocks the disk thread was not ahead of the audio thread
+        int getNumUnderruns() const;
+        void resetUnderruns();
+
+        void addListener(Listener* listener);
+        void removeListener(Listener* listener);
+
+        //Hand transport events to the listeners and free swapped out tracks (a timer does it on the message thread,
+        //call it directly when there is no message loop, as in offline rendering)
+        void dispatchTransportEvents();
+
+        //Set gain for vol
+        void setGain(double gain);
+        //Set ratio for speed
+        void setSpeed(double ratio);
+        //Keep the pitch when the speed changes (the corrected output runs getKeyLockLatency() secs behind the transport,
+        //and is faded in twice that long after switching on)
+        void setKeyLock(bool shouldLock);
+        bool isKeyLocked() const;
+        double getKeyLockLatency() const;
+        //Share of the real time the key lock of this deck takes (0.01 is 1% of a core)
+        double getKeyLockLoad() const;
+        //Set sec for position
+        void setPosition(double posInSecs);
+        //Set position relative
+        void setPositionRelative(double pos);
+
+        //Turn looping of the loaded track on or off (no reload)
+        void setLooping(bool looping);
+
+        //Set the cue point (in secs) and jump back to it (stopped)
+        void setCuePoint(double posInSecs);
+        void cue();
+
+        //Set the loop in point at the playhead
+        void loopIn();
+        //Set the loop out point at the playhead and start looping
+        void loopOut();
+        //Loop a number of beats (1/4 to 32) from the playhead, or resize the loop that is playing
+        void loopBeats(double beats);
+        //Loop the last loop again / carry on past its out point
+        void reloop();
+        void exitLoop();
+        //Tempo of the loaded track (beats per minute at speed 1) for beat loops
+        void setBPM(double bpm);
+        double getBPM() const;
+        //Loop in and out points in secs (-1 when not set) and whether the loop is playing
+        double getLoopInSeconds() const;
+        double getLoopOutSeconds() const;
+        bool isInLoop() const;
+
+        //Run a transport command at an exact sample of the deck's output clock
+        void scheduleCommand(const DeckTransport::Command& command);
+        //Number of samples the deck has rendered so far (its output clock)
+        juce::int64 getRenderPosition() const;
+
+        //Set Pass (none of the three is no filter)
+        void setPass(double cutOff, double Q, bool lowPass, bool highPass, bool bandPass);
+        //Set the gain of the low, mid and high bands of the isolator (0 kills a band, 1 leaves it, up to 2)
+        void setEQ(double low, double mid, double high);
+
+        //Play audio
+        void play();
+        //Pause audio
+        void stop();
+        
+        //Bool function to check if stream finished
+        bool checkStreamFinished();
+        //Replay audio
+        void replay();
+
+        //Get the relative position of the playhead
+        double getPositionRelative();
+        //Get the position of the playhead in secs
+        double getPositionInSeconds() const;
+        //Get the length of the loaded track in secs (0 when nothing could be loaded)
+        double getLengthInSeconds() const;
+
+    private:
+        //Called on the loader thread to swap a freshly opened track into the transport
+        void installLoadedTrack(TrackLoader::Result& result);
+        //Called on the next-track loader thread to hand the preloaded track to the transport
+        void installNextTrack(TrackLoader::Result& result);
+        //Wrap an opened source into a prepared transport track (loader threads only)
+        std::unique_ptr<DeckTransport::Track> makeTrack(TrackLoader::Result& result);
+        //Deliver the ready notification on the message thread
+        void handleAsyncUpdate() override;
+        //Drain the transport events on the message thread
+        void timerCallback() override;
+
+        juce::AudioFormatManager& formatManager;
+
+        //Read-ahead, the disk thread is shared by all decks
+        juce::TimeSliceThread& readAheadThread;
+        std::atomic<int> readAheadSize{ 65536 };
+        std::atomic<int> numUnderruns{ 0 };
+
+        //Decoded tracks shared by all decks
+        DecodedTrackCache& trackCache;
+
+        //Play head of the deck (reads the track at file rate and speed, sample-accurate events)
+        DeckTransport transport;
+        //Length of the last installed track, for relative positions
+        std::atomic<double> trackLength{ 0 };
+
+        //Parameter block written by the GUI and read once per block by the audio thread (lock-free)
+        std::atomic<float> targetGain{ 1.0f };
+        std::atomic<float> targetSpeed{ 1.0f };
+        std::atomic<double> trackBPM{ 120.0 };
+
+        //Smoothed values, only touched by the audio thread
+        juce::SmoothedValue<float> gainSmoothed;
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> speedSmoothed;
+
+        //Isolator and Pass filter (parameters are lock-free, the processing is audio thread only)
+        DeckEQ eq;
+
+        //Key lock, switched with a crossfade from the straight output kept in keyLockDry (audio thread only),
+        //switched on once it has warmed up (keyLockWarmUp samples still to feed it)
+        KeyLock keyLock;
+        std::atomic<bool> keyLockEnabled{ false };
+        bool keyLockActive = false;
+        bool keyLockWarming = false;
+        int keyLockWarmUp = 0;
+        juce::AudioBuffer<float> keyLockDry;
+        std::atomic<double> keyLockLoad{ 0 };
+
+        //Double variable to store the device sampleRate
+        double samRate = 44100.0;
+
+        //The lowest speed the transport is given
+        static constexpr float minSpeed = 0.01f;
+
+        //Background loader and the state shared with it (guarded by sourceLock)
+        juce::CriticalSection sourceLock;
+        int pendingLoadId = 0;
+        bool startWhenLoaded = false;
+        juce::URL readyURL;
+        bool readyLoaded = false;
+        TrackLoader loader{ formatManager, trackCache, [this](TrackLoader::Result& result) { installLoadedTrack(result); } };
+
+        //Next track, opened on its own loader so it never delays a load of the current track (guarded by sourceLock)
+        int pendingNextLoadId = 0;
+        juce::URL nextURL;
+        double nextTrackLength = 0;
+        TrackLoader nextLoader{ formatManager, trackCache, [this](TrackLoader::Result& result) { installNextTrack(result); } };
+
+        std::atomic<double> maxLoadBlockMs{ 0 };
+        juce::ListenerList<Listener> listeners;
+};
\ No newline at end of file
@@ -0,0 +1,350 @@
+/*
+  ==============================================================================
+
+    DeckEQ.cpp
+    Created: 29 Sep 2022 4:06:33pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "DeckEQ.h"
+
+DeckEQ::DeckEQ()
+{
+}
+
+DeckEQ::~DeckEQ()
+{
+}
+
+//==============================================================================
+void DeckEQ::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    juce::ignoreUnused(samplesPerBlockExpected);
+    currentSampleRate = sampleRate;
+
+    //Linkwitz-Riley crossovers: two Butterworth sections per side. The low band goes through the all-pass the
+    //high crossover adds to everything above it, so the three bands sum back to a flat response
+    const double butterworthQ = juce::MathConstants<double>::sqrt2 * 0.5;
+    auto lowPass = makeLowPass(sampleRate, lowCrossover, butterworthQ);
+    auto highPass = makeHighPass(sampleRate, lowCrossover, butterworthQ);
+    auto phaseMatch = makeAllPass(sampleRate, highCrossover, butterworthQ);
+    auto upperHighPass = makeHighPass(sampleRate, highCrossover, butterworthQ);
+
+    for (int lane = 0; lane < 4; ++lane)
+    {
+        lowSplitA.setCoefficients(lane, lane < 2 ? lowPass : highPass);
+        lowSplitB.setCoefficients(lane, lane < 2 ? lowPass : highPass);
+        highSplitA.setCoefficients(lane, lane < 2 ? phaseMatch : upperHighPass);
+    }
+    for (int lane = 0; lane < 2; ++lane)
+    {
+        highSplitB.setCoefficients(lane, upperHighPass);
+    }
+
+    //Ramp lengths: short enough to feel immediate, long enough to kill zipper noise
+    lowGain.reset(sampleRate, 0.02);
+    midGain.reset(sampleRate, 0.02);
+    highGain.reset(sampleRate, 0.02);
+    cutOffSmoothed.reset(sampleRate, 0.05);
+    QSmoothed.reset(sampleRate, 0.05);
+
+    reset();
+}
+
+void DeckEQ::reset()
+{
+    lowGain.setCurrentAndTargetValue(targetLow);
+    midGain.setCurrentAndTargetValue(targetMid);
+    highGain.setCurrentAndTargetValue(targetHigh);
+    cutOffSmoothed.setCurrentAndTargetValue(targetCutOff);
+    QSmoothed.setCurrentAndTargetValue(targetQ);
+
+    lowSplitA.clear();
+    lowSplitB.clear();
+    highSplitA.clear();
+    highSplitB.clear();
+    isolatorActive = lowGain.getTargetValue() != 1.0f || midGain.getTargetValue() != 1.0f || highGain.getTargetValue() != 1.0f;
+
+    currentType = targetType;
+    auto c = makeFilter(currentType, currentSampleRate, cutOffSmoothed.getTargetValue(), QSmoothed.getTargetValue());
+    filter.setCoefficients(0, c);
+    filter.setCoefficients(1, c);
+    filter.clear();
+    filterActive = currentType != noFilter;
+}
+
+void DeckEQ::setBandGains(float low, float mid, float high)
+{
+    targetLow = juce::jlimit(0.0f, maxBandGain, low);
+    targetMid = juce::jlimit(0.0f, maxBandGain, mid);
+    targetHigh = juce::jlimit(0.0f, maxBandGain, high);
+}
+
+void DeckEQ::setFilter(FilterType type, float cutOff, float Q)
+{
+    targetCutOff = cutOff;
+    targetQ = Q;
+    targetType = (int) type;
+}
+
+//==============================================================================
+void DeckEQ::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    int numChannels = juce::jmin(buffer.getNumChannels(), 2);
+    if (numChannels == 0 || numSamples <= 0)
+    {
+        return;
+    }
+
+    //The filters ring down into denormals when the track goes silent
+    juce::ScopedNoDenormals noDenormals;
+
+    //Pick up the latest parameters once per block
+    lowGain.setTargetValue(targetLow);
+    midGain.setTargetValue(targetMid);
+    highGain.setTargetValue(targetHigh);
+    cutOffSmoothed.setTargetValue(targetCutOff);
+    QSmoothed.setTargetValue(targetQ);
+
+    //A mono buffer goes through both lanes, the same result is written twice
+    auto* left = buffer.getWritePointer(0, startSample);
+    auto* right = buffer.getWritePointer(numChannels - 1, startSample);
+
+    processIsolator(left, right, numSamples);
+    processFilter(left, right, numSamples);
+}
+
+void DeckEQ::processIsolator(float* left, float* right, int numSamples)
+{
+    bool wanted = lowGain.isSmoothing() || midGain.isSmoothing() || highGain.isSmoothing()
+                  || lowGain.getTargetValue() != 1.0f || midGain.getTargetValue() != 1.0f || highGain.getTargetValue() != 1.0f;
+    if (!wanted && !isolatorActive)
+    {
+        return;
+    }
+
+    //Switching on or off: crossfade with the straight signal (the isolator shifts the phase) over one sub-block
+    int fadeLength = wanted != isolatorActive ? juce::jmin(subBlockSize, numSamples) : 0;
+    float wetStart = isolatorActive ? 1.0f : 0.0f;
+    float wetEnd = wanted ? 1.0f : 0.0f;
+    if (!isolatorActive)
+    {
+        lowSplitA.clear();
+        lowSplitB.clear();
+        highSplitA.clear();
+        highSplitB.clear();
+    }
+
+    //Switched off, the rest of the block is left as it is
+    int numToProcess = wanted ? numSamples : fadeLength;
+    for (int i = 0; i < numToProcess; ++i)
+    {
+        float l = left[i];
+        float r = right[i];
+        float low = lowGain.getNextValue();
+        float mid = midGain.getNextValue();
+        float high = highGain.getNextValue();
+
+        //Low band next to everything above it
+        float split[4] = { l, r, l, r };
+        lowSplitA.tick(split);
+        lowSplitB.tick(split);
+
+        //Low and mid-and-high bands weighted and phase matched, and the high pass of everything above the low band.
+        //The mid band is what is left of the upper part once its high band is taken out
+        float upper[4] = { low * split[0] + mid * split[2], low * split[1] + mid * split[3], split[2], split[3] };
+        highSplitA.tick(upper);
+        float top[2] = { upper[2], upper[3] };
+        highSplitB.tick(top);
+
+        float outLeft = upper[0] + (high - mid) * top[0];
+        float outRight = upper[1] + (high - mid) * top[1];
+
+        if (i < fadeLength)
+        {
+            float wet = wetStart + (wetEnd - wetStart) * (float) (i + 1) / (float) fadeLength;
+            outLeft = wet * outLeft + (1.0f - wet) * l;
+            outRight = wet * outRight + (1.0f - wet) * r;
+        }
+
+        left[i] = outLeft;
+        right[i] = outRight;
+    }
+
+    isolatorActive = wanted;
+}
+
+void DeckEQ::processFilter(float* left, float* right, int numSamples)
+{
+    int type = targetType;
+    if (type == noFilter && !filterActive)
+    {
+        cutOffSmoothed.skip(numSamples);
+        QSmoothed.skip(numSamples);
+        currentType = noFilter;
+        return;
+    }
+
+    //Switched on: start from the poles of the cut off with nothing but them in the numerator (a straight wire)
+    if (!filterActive)
+    {
+        auto c = makeFilter(noFilter, currentSampleRate, cutOffSmoothed.getCurrentValue(), QSmoothed.getCurrentValue());
+        filter.setCoefficients(0, c);
+        filter.setCoefficients(1, c);
+        filter.clear();
+        currentType = noFilter;
+        filterActive = true;
+    }
+
+    //Coefficients are recomputed every sub-block and interpolated sample by sample in between
+    //(on a local copy, so the states stay in registers)
+    auto lanes = filter;
+    int done = 0;
+    while (done < numSamples)
+    {
+        int numToDo = juce::jmin(subBlockSize, numSamples - done);
+        float* l = left + done;
+        float* r = right + done;
+
+        if (type != currentType || cutOffSmoothed.isSmoothing() || QSmoothed.isSmoothing())
+        {
+            auto c = makeFilter(type, currentSampleRate, cutOffSmoothed.skip(numToDo), QSmoothed.skip(numToDo));
+            lanes.interpolateTo(0, c, numToDo);
+            lanes.interpolateTo(1, c, numToDo);
+
+            for (int i = 0; i < numToDo; ++i)
+            {
+                float x[2] = { l[i], r[i] };
+                lanes.tickInterpolated(x);
+                l[i] = x[0];
+                r[i] = x[1];
+            }
+
+            //Land exactly on the target, whatever the rounding of the steps
+            lanes.setCoefficients(0, c);
+            lanes.setCoefficients(1, c);
+            currentType = type;
+        }
+        else
+        {
+            for (int i = 0; i < numToDo; ++i)
+            {
+                float x[2] = { l[i], r[i] };
+                lanes.tick(x);
+                l[i] = x[0];
+                r[i] = x[1];
+            }
+        }
+
+        done += numToDo;
+    }
+    filter = lanes;
+
+    //Switched off and the filter has rung out: stop running it
+    if (type == noFilter && currentType == noFilter)
+    {
+        float residue = juce::jmax(std::abs(filter.z1[0]), std::abs(filter.z2[0]), std::abs(filter.z1[1]), std::abs(filter.z2[1]));
+        if (residue < 1.0e-5f)
+        {
+            filter.clear();
+            filterActive = false;
+        }
+    }
+}
+
+//==============================================================================
+//Audio EQ cookbook (bilinear transform with the frequency prewarped), normalised by a0
+DeckEQ::Coefficients DeckEQ::makeLowPass(double rate, double frequency, double Q)
+{
+    double w0 = juce::MathConstants<double>::twoPi * frequency / rate;
+    double cosW0 = std::cos(w0);
+    double alpha = std::sin(w0) / (2.0 * Q);
+    double a0 = 1.0 + alpha;
+
+    Coefficients c;
+    c.b0 = (float) ((1.0 - cosW0) * 0.5 / a0);
+    c.b1 = (float) ((1.0 - cosW0) / a0);
+    c.b2 = c.b0;
+    c.a1 = (float) (-2.0 * cosW0 / a0);
+    c.a2 = (float) ((1.0 - alpha) / a0);
+    return c;
+}
+
+DeckEQ::Coefficients DeckEQ::makeHighPass(double rate, double frequency, double Q)
+{
+    double w0 = juce::MathConstants<double>::twoPi * frequency / rate;
+    double cosW0 = std::cos(w0);
+    double alpha = std::sin(w0) / (2.0 * Q);
+    double a0 = 1.0 + alpha;
+
+    Coefficients c;
+    c.b0 = (float) ((1.0 + cosW0) * 0.5 / a0);
+    c.b1 = (float) (-(1.0 + cosW0) / a0);
+    c.b2 = c.b0;
+    c.a1 = (float) (-2.0 * cosW0 / a0);
+    c.a2 = (float) ((1.0 - alpha) / a0);
+    return c;
+}
+
+DeckEQ::Coefficients DeckEQ::makeBandPass(double rate, double frequency, double Q)
+{
+    //0 dB at the centre
+    double w0 = juce::MathConstants<double>::twoPi * frequency / rate;
+    double cosW0 = std::cos(w0);
+    double alpha = std::sin(w0) / (2.0 * Q);
+    double a0 = 1.0 + alpha;
+
+    Coefficients c;
+    c.b0 = (float) (alpha / a0);
+    c.b1 = 0.0f;
+    c.b2 = -c.b0;
+    c.a1 = (float) (-2.0 * cosW0 / a0);
+    c.a2 = (float) ((1.0 - alpha) / a0);
+    return c;
+}
+
+DeckEQ::Coefficients DeckEQ::makeAllPass(double rate, double frequency, double Q)
+{
+    double w0 = juce::MathConstants<double>::twoPi * frequency / rate;
+    double cosW0 = std::cos(w0);
+    double alpha = std::sin(w0) / (2.0 * Q);
+    double a0 = 1.0 + alpha;
+
+    Coefficients c;
+    c.b0 = (float) ((1.0 - alpha) / a0);
+    c.b1 = (float) (-2.0 * cosW0 / a0);
+    c.b2 = 1.0f;
+    c.a1 = c.b1;
+    c.a2 = c.b0;
+    return c;
+}
+
+DeckEQ::Coefficients DeckEQ::makeFilter(int type, double rate, double frequency, double Q)
+{
+    //Keep the cut off below Nyquist and the Q where the filter stays sane
+    frequency = juce::jlimit(10.0, rate * 0.49, frequency);
+    Q = juce::jmax(0.1, Q);
+
+    //Every type shares the poles of a cut off and Q, only the numerator changes, so
+    //interpolating from one type to another never leaves the stable region
+    if (type == lowPassFilter)
+    {
+        return makeLowPass(rate, frequency, Q);
+    }
+    if (type == highPassFilter)
+    {
+        return makeHighPass(rate, frequency, Q);
+    }
+    if (type == bandPassFilter)
+    {
+        return makeBandPass(rate, frequency, Q);
+    }
+
+    auto c = makeLowPass(rate, frequency, Q);
+    c.b0 = 1.0f;
+    c.b1 = c.a1;
+    c.b2 = c.a2;
+    return c;
+}
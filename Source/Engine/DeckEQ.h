@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    DeckEQ.h
+    Created: 29 Sep 2022 4:06:33pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    The EQ section of a deck: a 3-band isolator followed by a sweepable filter.
+
+    The isolator splits the track with Linkwitz-Riley crossovers (24 dB/oct) at
+    lowCrossover and highCrossover, so turning a band down to 0 kills it and
+    leaving every band at 1 keeps a flat response. It is built from biquads run
+    four at a time, one per lane: the low and high halves of a crossover, each
+    for both channels, go through the same multiply-adds. That is four lane
+    groups per sample for the whole isolator.
+
+    The filter (low pass, high pass or band pass at a cut off and Q) is one
+    biquad for both channels in a lane pair. Its coefficients are recomputed
+    every subBlockSize samples from the smoothed cut off and Q and interpolated
+    sample by sample in between, so sweeps and switching the filter on, off or
+    to another type are free of zipper noise and clicks.
+
+    Each part is skipped while it has nothing to do: the isolator while every
+    band sits at 1, the filter while it is off.
+*/
+class DeckEQ
+{
+public:
+    enum FilterType
+    {
+        noFilter = 0,
+        lowPassFilter,
+        highPassFilter,
+        bandPassFilter
+    };
+
+    DeckEQ();
+    ~DeckEQ();
+
+    //Allocates nothing, but it is never called while the audio callback is running
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+    //Forget the filter states and jump to the parameters (audio thread)
+    void reset();
+
+    //Gain of each band, 0 kills it, 1 leaves it and maxBandGain boosts it (any thread)
+    void setBandGains(float low, float mid, float high);
+    //Filter type, cut off (Hz) and Q (any thread)
+    void setFilter(FilterType type, float cutOff, float Q);
+
+    //EQ numSamples in place (audio thread)
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    static constexpr float maxBandGain = 2.0f;
+    static constexpr double lowCrossover = 250.0;
+    static constexpr double highCrossover = 2500.0;
+
+private:
+    //Normalised biquad coefficients (a0 is 1)
+    struct Coefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    static Coefficients makeLowPass(double rate, double frequency, double Q);
+    static Coefficients makeHighPass(double rate, double frequency, double Q);
+    static Coefficients makeBandPass(double rate, double frequency, double Q);
+    static Coefficients makeAllPass(double rate, double frequency, double Q);
+    //A filter of a type at a cut off and Q, noFilter keeps the poles and cancels them (so it morphs into the others)
+    static Coefficients makeFilter(int type, double rate, double frequency, double Q);
+
+    //numLanes independent biquads (transposed direct form II) run side by side
+    template <int numLanes>
+    struct BiquadLanes
+    {
+        float b0[numLanes] = {}, b1[numLanes] = {}, b2[numLanes] = {}, a1[numLanes] = {}, a2[numLanes] = {};
+        //Change per sample while the coefficients are being interpolated
+        float db0[numLanes] = {}, db1[numLanes] = {}, db2[numLanes] = {}, da1[numLanes] = {}, da2[numLanes] = {};
+        float z1[numLanes] = {}, z2[numLanes] = {};
+
+        void setCoefficients(int lane, const Coefficients& c)
+        {
+            b0[lane] = c.b0; b1[lane] = c.b1; b2[lane] = c.b2; a1[lane] = c.a1; a2[lane] = c.a2;
+        }
+
+        //Move lane to c linearly over numSamples calls of tickInterpolated
+        void interpolateTo(int lane, const Coefficients& c, int numSamples)
+        {
+            float scale = 1.0f / (float) numSamples;
+            db0[lane] = (c.b0 - b0[lane]) * scale;
+            db1[lane] = (c.b1 - b1[lane]) * scale;
+            db2[lane] = (c.b2 - b2[lane]) * scale;
+            da1[lane] = (c.a1 - a1[lane]) * scale;
+            da2[lane] = (c.a2 - a2[lane]) * scale;
+        }
+
+        void clear()
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                z1[lane] = 0.0f;
+                z2[lane] = 0.0f;
+            }
+        }
+
+        //One sample through every lane, in place
+        inline void tick(float* x)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                float y = b0[lane] * x[lane] + z1[lane];
+                z1[lane] = b1[lane] * x[lane] - a1[lane] * y + z2[lane];
+                z2[lane] = b2[lane] * x[lane] - a2[lane] * y;
+                x[lane] = y;
+            }
+        }
+
+        inline void tickInterpolated(float* x)
+        {
+            tick(x);
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                b0[lane] += db0[lane];
+                b1[lane] += db1[lane];
+                b2[lane] += db2[lane];
+                a1[lane] += da1[lane];
+                a2[lane] += da2[lane];
+            }
+        }
+    };
+
+    void processIsolator(float* left, float* right, int numSamples);
+    void processFilter(float* left, float* right, int numSamples);
+
+    double currentSampleRate = 44100.0;
+
+    //Parameters written by any thread and read once per block by the audio thread (lock-free)
+    std::atomic<float> targetLow{ 1.0f };
+    std::atomic<float> targetMid{ 1.0f };
+    std::atomic<float> targetHigh{ 1.0f };
+    std::atomic<int> targetType{ noFilter };
+    std::atomic<float> targetCutOff{ 20000.0f };
+    std::atomic<float> targetQ{ 0.7f };
+
+    //Isolator: [low, high] half of the low crossover, twice, then the phase match of the low band next to the
+    //first half of the high pass at the high crossover, then its second half (lanes are L, R, L, R)
+    BiquadLanes<4> lowSplitA, lowSplitB, highSplitA;
+    BiquadLanes<2> highSplitB;
+    juce::SmoothedValue<float> lowGain, midGain, highGain;
+    bool isolatorActive = false;
+
+    //Filter (lanes are L, R)
+    BiquadLanes<2> filter;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> cutOffSmoothed;
+    juce::SmoothedValue<float> QSmoothed;
+    int currentType = noFilter;
+    bool filterActive = false;
+
+    //Samples between filter coefficient updates
+    static constexpr int subBlockSize = 32;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckEQ)
+};
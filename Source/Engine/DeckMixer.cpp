@@ -0,0 +1,358 @@
+/*
+  ==============================================================================
+
+    DeckMixer.cpp
+    Created: 14 Sep 2022 10:21:37am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "DeckMixer.h"
+
+DeckMixer::DeckMixer()
+{
+}
+
+DeckMixer::~DeckMixer()
+{
+}
+
+//==============================================================================
+void DeckMixer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    blockSize = samplesPerBlockExpected;
+    samRate = sampleRate;
+
+    for (int i = 0; i < numInputs; ++i)
+    {
+        for (auto& buffer : channels[i].buffers)
+        {
+            buffer.setSize(2, blockSize);
+            buffer.clear();
+        }
+        channels[i].source->prepareToPlay(blockSize, samRate);
+    }
+}
+
+void DeckMixer::releaseResources()
+{
+    for (int i = 0; i < numInputs; ++i)
+    {
+        channels[i].source->releaseResources();
+    }
+}
+
+void DeckMixer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto callbackStart = juce::Time::getHighResolutionTicks();
+    bufferToFill.clearActiveBufferRegion();
+
+    int n = numInputs.load(std::memory_order_acquire);
+    if (blockSize == 0)   //Not prepared yet
+    {
+        return;
+    }
+
+    //The device may ask for more than it announced, render it in pieces that fit the channel buffers
+    int done = 0;
+    while (done < bufferToFill.numSamples)
+    {
+        int numSamples = juce::jmin(blockSize, bufferToFill.numSamples - done);
+
+        {
+            OTODESKS_PROFILE_SCOPE("DeckMixer::renderInputs");
+            renderInputs(n, numSamples, callbackStart);
+        }
+        {
+            OTODESKS_PROFILE_SCOPE("DeckMixer::sumInputs");
+            sumInputs(n, *bufferToFill.buffer, bufferToFill.startSample + done, numSamples);
+        }
+
+        done += numSamples;
+    }
+
+    //Master gain, ramped when it moves
+    float gain = masterGain;
+    bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples, lastMasterGain, gain);
+    lastMasterGain = gain;
+
+    //Headroom meters
+    for (int ch = 0; ch < juce::jmin(bufferToFill.buffer->getNumChannels(), 2); ++ch)
+    {
+        float peak = bufferToFill.buffer->getMagnitude(ch, bufferToFill.startSample, bufferToFill.numSamples);
+        if (peak > masterPeak[ch])
+        {
+            masterPeak[ch] = peak;
+        }
+        if (peak > maxPeak)
+        {
+            maxPeak = peak;
+        }
+        if (peak > 1.0f)
+        {
+            ++numClips;
+        }
+    }
+}
+
+void DeckMixer::renderInputs(int numInputs, int numSamples, juce::int64 callbackStart)
+{
+    numSamplesToRender = numSamples;
+    auto* pool = renderPool.load();
+
+    if (pool == nullptr || pool->getNumWorkers() == 0 || numInputs < 2)   //Nothing to share, render them one by one
+    {
+        for (int i = 0; i < numInputs; ++i)
+        {
+            renderJob(i);
+            channels[i].rendered = true;
+            swapBuffers(channels[i]);
+        }
+        return;
+    }
+
+    //Inputs are independent, spread them over the pool and give them a share of the block time
+    auto blockTicks = juce::Time::secondsToHighResolutionTicks(numSamples / samRate);
+    auto deadline = renderDeadline > 0 ? callbackStart + (juce::int64) (blockTicks * renderDeadline)
+                                       : std::numeric_limits<juce::int64>::max();
+    pool->run(*this, numInputs, deadline);
+
+    for (int i = 0; i < numInputs; ++i)
+    {
+        //A late one is still writing into its back buffer, it is left alone until it has finished
+        channels[i].rendered = pool->isFinished(i);
+        if (channels[i].rendered)
+        {
+            swapBuffers(channels[i]);
+        }
+    }
+}
+
+void DeckMixer::swapBuffers(Channel& channel)
+{
+    channel.front = channel.back.load(std::memory_order_relaxed);
+    channel.back.store(1 - channel.front, std::memory_order_relaxed);
+}
+
+void DeckMixer::renderJob(int index)
+{
+    OTODESKS_PROFILE_SCOPE("DeckMixer::renderJob");
+    auto& channel = channels[index];
+    channel.source->getNextAudioBlock(juce::AudioSourceChannelInfo(&channel.buffers[channel.back.load(std::memory_order_relaxed)], 0, numSamplesToRender));
+}
+
+void DeckMixer::sumInputs(int numInputs, juce::AudioBuffer<float>& output, int startSample, int numSamples)
+{
+    auto fCurve = (FaderCurve) faderCurve.load();
+    auto xCurve = (CrossfaderCurve) crossfaderCurve.load();
+    float position = crossfader;
+    int numOutputs = output.getNumChannels();
+
+    for (int i = 0; i < numInputs; ++i)
+    {
+        auto& channel = channels[i];
+        float gain = faderGain(channel.fader, fCurve) * crossfaderGain(position, (Side) channel.side.load(), xCurve);
+        const auto& buffer = channel.buffers[channel.front];
+
+        if (!channel.rendered)   //Missed the deadline: the block it played before ramps out, it comes back in with a ramp
+        {
+            if (channel.lastGain > 0.0f)
+            {
+                for (int ch = 0; ch < numOutputs; ++ch)
+                {
+                    output.addFromWithRamp(ch, startSample, buffer.getReadPointer(juce::jmin(ch, buffer.getNumChannels() - 1)),
+                                           numSamples, channel.lastGain, 0.0f);
+                }
+            }
+            channel.lastGain = 0.0f;
+            continue;
+        }
+
+        if (gain == 0.0f && channel.lastGain == 0.0f)   //Closed, nothing to add
+        {
+            continue;
+        }
+
+        for (int ch = 0; ch < numOutputs; ++ch)
+        {
+            const float* in = buffer.getReadPointer(juce::jmin(ch, buffer.getNumChannels() - 1));
+
+            if (gain == channel.lastGain)
+            {
+                juce::FloatVectorOperations::addWithMultiply(output.getWritePointer(ch, startSample), in, gain, numSamples);
+            }
+            else
+            {
+                output.addFromWithRamp(ch, startSample, in, numSamples, channel.lastGain, gain);
+            }
+        }
+
+        float peak = buffer.getMagnitude(0, numSamples) * juce::jmax(gain, channel.lastGain);
+        if (peak > channel.peak)
+        {
+            channel.peak = peak;
+        }
+
+        channel.lastGain = gain;
+    }
+}
+
+//==============================================================================
+int DeckMixer::addInput(juce::AudioSource* input, Side side)
+{
+    int index = numInputs;
+    if (index == maxInputs)
+    {
+        std::cout << "DeckMixer::addInput no channel left for another input." << std::endl;
+        return -1;
+    }
+
+    auto& channel = channels[index];
+    channel.source = input;
+    channel.side = side;
+    channel.fader = 1.0f;
+    channel.peak = 0.0f;
+    channel.lastGain = 0.0f;
+
+    //Prepared here so the audio thread only ever sees ready channels
+    if (blockSize > 0)
+    {
+        for (auto& buffer : channel.buffers)
+        {
+            buffer.setSize(2, blockSize);
+            buffer.clear();
+        }
+        input->prepareToPlay(blockSize, samRate);
+    }
+
+    numInputs.store(index + 1, std::memory_order_release);
+    return index;
+}
+
+int DeckMixer::getNumInputs() const
+{
+    return numInputs;
+}
+
+void DeckMixer::setRenderPool(DeckRenderPool* pool)
+{
+    renderPool = pool;
+}
+
+void DeckMixer::setRenderDeadline(double fractionOfBlock)
+{
+    //0 (or less) waits for every input, whatever it takes (offline rendering)
+    renderDeadline = fractionOfBlock <= 0 ? 0.0 : juce::jlimit(0.1, 1.0, fractionOfBlock);
+}
+
+void DeckMixer::setFader(int channel, float value)
+{
+    if (channel < 0 || channel >= numInputs)
+    {
+        std::cout << "DeckMixer::setFader no such channel." << std::endl;
+    }
+    else
+    {
+        channels[channel].fader = juce::jlimit(0.0f, 1.0f, value);
+    }
+}
+
+void DeckMixer::setSide(int channel, Side side)
+{
+    if (channel < 0 || channel >= numInputs)
+    {
+        std::cout << "DeckMixer::setSide no such channel." << std::endl;
+    }
+    else
+    {
+        channels[channel].side = side;
+    }
+}
+
+void DeckMixer::setFaderCurve(FaderCurve curve)
+{
+    faderCurve = curve;
+}
+
+void DeckMixer::setCrossfader(float position)
+{
+    crossfader = juce::jlimit(0.0f, 1.0f, position);
+}
+
+void DeckMixer::setCrossfaderCurve(CrossfaderCurve curve)
+{
+    crossfaderCurve = curve;
+}
+
+void DeckMixer::setMasterGain(float gain)
+{
+    masterGain = juce::jmax(0.0f, gain);
+}
+
+float DeckMixer::takeInputPeak(int channel)
+{
+    if (channel < 0 || channel >= numInputs)
+    {
+        return 0.0f;
+    }
+    return channels[channel].peak.exchange(0.0f);
+}
+
+float DeckMixer::takeMasterPeak(int outputChannel)
+{
+    return masterPeak[juce::jlimit(0, 1, outputChannel)].exchange(0.0f);
+}
+
+float DeckMixer::getHeadroomDb() const
+{
+    return -juce::Decibels::gainToDecibels(maxPeak.load());
+}
+
+int DeckMixer::getNumClips() const
+{
+    return numClips;
+}
+
+void DeckMixer::resetMeters()
+{
+    maxPeak = 0.0f;
+    numClips = 0;
+}
+
+//==============================================================================
+float DeckMixer::faderGain(float value, FaderCurve curve)
+{
+    if (value <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    if (curve == audioTaperFader)
+    {
+        return juce::Decibels::decibelsToGain(-60.0f * (1.0f - value));
+    }
+    return value;
+}
+
+float DeckMixer::crossfaderGain(float position, Side side, CrossfaderCurve curve)
+{
+    if (side == thru)
+    {
+        return 1.0f;
+    }
+
+    //Distance from the other side: 1 when the crossfader is fully on this side
+    float x = side == sideA ? 1.0f - position : position;
+
+    if (curve == linearCrossfader)
+    {
+        return x;
+    }
+    if (curve == cutCrossfader)
+    {
+        //Fully open for all but the last 5% of the travel
+        return juce::jmin(1.0f, x / 0.05f);
+    }
+    return std::sin(x * juce::MathConstants<float>::halfPi);
+}
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    DeckMixer.h
+    Created: 14 Sep 2022 10:21:37am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DeckRenderPool.h"
+
+//==============================================================================
+/*
+    Mixes any number of decks into the output. Every input gets its own channel
+    with a fader and a crossfader side, and the sum goes through the master gain
+    and the headroom meters.
+
+    The audio callback never locks and never allocates: inputs are added on the
+    message thread into a fixed set of channels (their buffers are allocated
+    there) and published with an atomic count, settings are atomics, and each
+    input is summed with a vectorised multiply-add, ramping when its gain moves.
+
+    With a render pool the inputs are rendered in parallel, the audio thread
+    rendering any input no worker has started yet. An input that misses the
+    deadline ramps out of that block (on the block it played before) and ramps
+    back in on the next one it makes; each input renders into one of two
+    buffers and is summed from the other, so a late render never writes into
+    what is being summed.
+*/
+class DeckMixer : public juce::AudioSource,
+                  private DeckRenderPool::Task
+{
+public:
+    //Which side of the crossfader a channel is on (thru ignores the crossfader)
+    enum Side
+    {
+        thru = 0,
+        sideA,
+        sideB
+    };
+
+    //How the position of a channel fader maps to a gain
+    enum FaderCurve
+    {
+        linearFader = 0,
+        audioTaperFader     //dB scale, -60 dB at the bottom
+    };
+
+    //How the crossfader position maps to the gains of both sides
+    enum CrossfaderCurve
+    {
+        smoothCrossfader = 0,   //equal power, no dip in the middle
+        linearCrossfader,
+        cutCrossfader           //both sides fully open but at the very ends (scratch)
+    };
+
+    DeckMixer();
+    ~DeckMixer() override;
+
+    //==============================================================================
+    //Virtual pure functions from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //Add an input (message thread only, not owned), returns its channel or -1 if there is no channel left
+    int addInput(juce::AudioSource* input, Side side);
+    int getNumInputs() const;
+
+    //Render the inputs on a pool (message thread, before the audio starts), nullptr renders them one by one
+    void setRenderPool(DeckRenderPool* pool);
+    //Fraction of the block time the inputs are given before the late ones are left out (0 waits for all of them)
+    void setRenderDeadline(double fractionOfBlock);
+
+    //Channel fader between 0 and 1
+    void setFader(int channel, float value);
+    void setSide(int channel, Side side);
+    void setFaderCurve(FaderCurve curve);
+
+    //Crossfader between 0 (side A) and 1 (side B)
+    void setCrossfader(float position);
+    void setCrossfaderCurve(CrossfaderCurve curve);
+
+    void setMasterGain(float gain);
+
+    //Peak of a channel after its fader (and of a master output channel) since the last call
+    float takeInputPeak(int channel);
+    float takeMasterPeak(int outputChannel);
+    //Headroom left (in dB below full scale) at the loudest master peak since the meters were reset
+    float getHeadroomDb() const;
+    //Number of blocks that went over full scale since the meters were reset
+    int getNumClips() const;
+    void resetMeters();
+
+    //Gain of a fader position, and of a crossfader position for one side
+    static float faderGain(float value, FaderCurve curve);
+    static float crossfaderGain(float position, Side side, CrossfaderCurve curve);
+
+    static constexpr int maxInputs = 16;
+
+private:
+    struct Channel
+    {
+        juce::AudioSource* source = nullptr;
+        //Where the input renders (buffers[back], on any thread of the pool) and is summed from (buffers[front],
+        //the last block it made in time), swapped on the audio thread when a render is in time (allocated on the message thread)
+        juce::AudioBuffer<float> buffers[2];
+        std::atomic<int> back{ 0 };
+        int front = 1;
+        std::atomic<float> fader{ 1.0f };
+        std::atomic<int> side{ thru };
+        std::atomic<float> peak{ 0.0f };
+        //Gain the last block ended on, and whether the input made it into this block (audio thread only)
+        float lastGain = 0.0f;
+        bool rendered = false;
+    };
+
+    //Render every input into its own buffer (audio thread)
+    void renderInputs(int numInputs, int numSamples, juce::int64 callbackStart);
+    //Render one input, on the audio thread or on a worker of the pool
+    void renderJob(int index) override;
+    //Sum the block an input has just rendered from now on, and render the next one into the other buffer (audio thread)
+    void swapBuffers(Channel& channel);
+    //Sum the inputs into the output (audio thread)
+    void sumInputs(int numInputs, juce::AudioBuffer<float>& output, int startSample, int numSamples);
+
+    Channel channels[maxInputs];
+    std::atomic<int> numInputs{ 0 };
+
+    std::atomic<DeckRenderPool*> renderPool{ nullptr };
+    std::atomic<double> renderDeadline{ 0.75 };
+    //Samples in the batch the pool is rendering (read by the workers)
+    std::atomic<int> numSamplesToRender{ 0 };
+
+    std::atomic<int> faderCurve{ linearFader };
+    std::atomic<float> crossfader{ 0.5f };
+    std::atomic<int> crossfaderCurve{ smoothCrossfader };
+    std::atomic<float> masterGain{ 1.0f };
+    float lastMasterGain = 1.0f;
+
+    std::atomic<float> masterPeak[2] = { { 0.0f }, { 0.0f } };
+    std::atomic<float> maxPeak{ 0.0f };
+    std::atomic<int> numClips{ 0 };
+
+    //Settings of the last prepareToPlay, used to prepare inputs added later
+    int blockSize = 0;
+    double samRate = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckMixer)
+};
@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    DeckRegistry.cpp
+    Created: 18 Sep 2022 11:42:05am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "DeckRegistry.h"
+
+DeckRegistry::DeckRegistry(juce::AudioFormatManager& _formatManager,
+                           juce::TimeSliceThread& _readAheadThread,
+                           DecodedTrackCache& _trackCache,
+                           DeckMixer& _mixer) : formatManager(_formatManager),
+                                                readAheadThread(_readAheadThread),
+                                                trackCache(_trackCache),
+                                                mixer(_mixer)
+{
+}
+
+DeckRegistry::~DeckRegistry()
+{
+}
+
+DJAudioPlayer* DeckRegistry::addDeck(DeckMixer::Side side)
+{
+    if (decks.size() == maxDecks || mixer.getNumInputs() == DeckMixer::maxInputs)
+    {
+        std::cout << "DeckRegistry::addDeck no room for another deck." << std::endl;
+        return nullptr;
+    }
+
+    auto* deck = new DJAudioPlayer(formatManager, readAheadThread, trackCache);
+    deck->setReadAheadSize(readAheadSize);
+    deck->setResamplingQuality(resamplingQuality);
+
+    //Owned before the mixer sees it, the mixer only ever holds a pointer
+    decks.add(deck);
+    channels.add(mixer.addInput(deck, side));
+    return deck;
+}
+
+DJAudioPlayer* DeckRegistry::addSampler()
+{
+    if (samplers.size() == maxSamplers || mixer.getNumInputs() == DeckMixer::maxInputs)
+    {
+        std::cout << "DeckRegistry::addSampler no room for another sampler." << std::endl;
+        return nullptr;
+    }
+
+    auto* sampler = new DJAudioPlayer(formatManager, readAheadThread, trackCache);
+    sampler->setReadAheadSize(readAheadSize);
+    sampler->setResamplingQuality(resamplingQuality);
+
+    samplers.add(sampler);
+    mixer.addInput(sampler, DeckMixer::thru);
+    return sampler;
+}
+
+int DeckRegistry::getNumDecks() const
+{
+    return decks.size();
+}
+
+DJAudioPlayer* DeckRegistry::getDeck(int index) const
+{
+    return decks[index];
+}
+
+int DeckRegistry::getChannel(int index) const
+{
+    return channels[index];
+}
+
+int DeckRegistry::getNumSamplers() const
+{
+    return samplers.size();
+}
+
+DJAudioPlayer* DeckRegistry::getSampler(int index) const
+{
+    return samplers[index];
+}
+
+void DeckRegistry::setReadAheadSize(int numSamples)
+{
+    readAheadSize = numSamples;
+    for (auto* deck : decks)
+    {
+        deck->setReadAheadSize(numSamples);
+    }
+    for (auto* sampler : samplers)
+    {
+        sampler->setReadAheadSize(numSamples);
+    }
+}
+
+void DeckRegistry::setResamplingQuality(ResamplingKernel::Quality quality)
+{
+    resamplingQuality = quality;
+    for (auto* deck : decks)
+    {
+        deck->setResamplingQuality(quality);
+    }
+    for (auto* sampler : samplers)
+    {
+        sampler->setResamplingQuality(quality);
+    }
+}
+
+ResamplingKernel::Quality DeckRegistry::getResamplingQuality() const
+{
+    return resamplingQuality;
+}
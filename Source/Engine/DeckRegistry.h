@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    DeckRegistry.h
+    Created: 18 Sep 2022 11:42:05am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "DeckMixer.h"
+
+//==============================================================================
+/*
+    Owns the audio players of every deck and sampler and plugs each new one into the mixer.
+    Decks are created at runtime on the message thread, they share the format
+    manager, the read-ahead thread and the decoded track cache.
+*/
+class DeckRegistry
+{
+public:
+    DeckRegistry(juce::AudioFormatManager& _formatManager,
+                 juce::TimeSliceThread& _readAheadThread,
+                 DecodedTrackCache& _trackCache,
+                 DeckMixer& _mixer);
+    ~DeckRegistry();
+
+    //Create a deck on a side of the crossfader (message thread only), returns nullptr when the mixer is full
+    DJAudioPlayer* addDeck(DeckMixer::Side side);
+    //Create a sampler deck, it skips the crossfader (message thread only), returns nullptr when the mixer is full
+    DJAudioPlayer* addSampler();
+
+    int getNumDecks() const;
+    DJAudioPlayer* getDeck(int index) const;
+    //Mixer channel of a deck
+    int getChannel(int index) const;
+
+    int getNumSamplers() const;
+    DJAudioPlayer* getSampler(int index) const;
+
+    //Read-ahead size (in samples of the file) given to every deck
+    void setReadAheadSize(int numSamples);
+    //Resampling quality given to every deck
+    void setResamplingQuality(ResamplingKernel::Quality quality);
+    ResamplingKernel::Quality getResamplingQuality() const;
+
+    static constexpr int maxDecks = 8;
+    static constexpr int maxSamplers = 4;
+
+private:
+    juce::AudioFormatManager& formatManager;
+    juce::TimeSliceThread& readAheadThread;
+    DecodedTrackCache& trackCache;
+    DeckMixer& mixer;
+
+    juce::OwnedArray<DJAudioPlayer> decks;
+    juce::Array<int> channels;
+    juce::OwnedArray<DJAudioPlayer> samplers;
+    int readAheadSize = 65536;
+    ResamplingKernel::Quality resamplingQuality = ResamplingKernel::mediumQuality;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckRegistry)
+};
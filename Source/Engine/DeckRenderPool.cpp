@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+
+    DeckRenderPool.cpp
+    Created: 17 Sep 2022 3:08:14pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "DeckRenderPool.h"
+
+//==============================================================================
+class DeckRenderPool::Worker : public juce::Thread
+{
+public:
+    Worker(DeckRenderPool& _pool, int index) : juce::Thread("Deck render " + juce::String(index)),
+                                               pool(_pool)
+    {
+    }
+
+    void run() override
+    {
+        AudioProfiler::nameThread("Deck render");
+
+        juce::uint32 lastBatch = 0;
+
+        while (!threadShouldExit())
+        {
+            auto batch = (juce::uint32) (pool.work.load(std::memory_order_acquire) >> 32);
+
+            if (batch != lastBatch)   //A new batch, help with it
+            {
+                lastBatch = batch;
+                //Workers have no deadline, a job they have claimed is finished even when it is late
+                pool.runJobs(batch, std::numeric_limits<juce::int64>::max());
+            }
+            else
+            {
+                //Sleep until the next batch (a batch published since the check above has signalled already, so it is not missed)
+                wait(-1);
+            }
+        }
+    }
+
+private:
+    DeckRenderPool& pool;
+};
+
+//==============================================================================
+DeckRenderPool::DeckRenderPool(int numWorkers)
+{
+    for (int i = 0; i < maxJobs; ++i)
+    {
+        busy[i] = false;
+        finishedBatch[i] = 0;
+    }
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto* worker = workers.add(new Worker(*this, i));
+        worker->startThread(juce::Thread::realtimeAudioPriority);
+    }
+}
+
+DeckRenderPool::~DeckRenderPool()
+{
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+    for (auto* worker : workers)
+    {
+        worker->stopThread(1000);
+    }
+}
+
+void DeckRenderPool::run(Task& task, int numJobs, juce::int64 deadlineTicks)
+{
+    numJobs = juce::jmin(numJobs, maxJobs);
+    juce::uint32 batch = ++batchCounter;
+    if (batch == 0)   //0 means no batch yet for the workers
+    {
+        batch = ++batchCounter;
+    }
+
+    //Publish the batch: everything is written before the batch number that workers look at
+    currentTask.store(&task, std::memory_order_relaxed);
+    numJobsInBatch.store(numJobs, std::memory_order_relaxed);
+    work.store((juce::uint64) batch << 32, std::memory_order_release);
+
+    for (auto* worker : workers)
+    {
+        worker->notify();
+    }
+
+    //Work on it too: whatever no worker has claimed yet is rendered here, until the deadline
+    runJobs(batch, deadlineTicks);
+
+    //Wait for the jobs the workers are still on, until the deadline
+    OTODESKS_PROFILE_SCOPE("DeckRenderPool::wait");
+    for (;;)
+    {
+        bool allFinished = true;
+        for (int i = 0; i < numJobs; ++i)
+        {
+            if (finishedBatch[i].load(std::memory_order_acquire) != batch)
+            {
+                allFinished = false;
+                break;
+            }
+        }
+
+        if (allFinished)
+        {
+            return;
+        }
+        if (juce::Time::getHighResolutionTicks() >= deadlineTicks)
+        {
+            //Close the batch: the jobs nobody has claimed are not started late (the ones running finish on their own)
+            work.store(((juce::uint64) batch << 32) | (juce::uint32) numJobs, std::memory_order_release);
+            ++numLateBatches;
+            AudioProfiler::mark("Late batch");
+            return;
+        }
+    }
+}
+
+void DeckRenderPool::runJobs(juce::uint32 batch, juce::int64 deadlineTicks)
+{
+    for (;;)
+    {
+        if (juce::Time::getHighResolutionTicks() >= deadlineTicks)   //Too late to start another one
+        {
+            return;
+        }
+
+        auto current = work.load(std::memory_order_acquire);
+        if ((juce::uint32) (current >> 32) != batch)   //A newer batch has started, this one is over
+        {
+            return;
+        }
+
+        auto index = (int) (current & 0xffffffff);
+        if (index >= numJobsInBatch.load(std::memory_order_relaxed))   //Every job is claimed
+        {
+            return;
+        }
+
+        if (!work.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel))
+        {
+            continue;
+        }
+
+        //Still running from a batch that missed its deadline: leave it out of this one
+        if (busy[index].exchange(true, std::memory_order_acquire))
+        {
+            continue;
+        }
+
+        currentTask.load(std::memory_order_relaxed)->renderJob(index);
+
+        finishedBatch[index].store(batch, std::memory_order_release);
+        busy[index].store(false, std::memory_order_release);
+    }
+}
+
+bool DeckRenderPool::isFinished(int index) const
+{
+    return finishedBatch[index].load(std::memory_order_acquire) == batchCounter;
+}
+
+int DeckRenderPool::getNumWorkers() const
+{
+    return workers.size();
+}
+
+int DeckRenderPool::getNumLateBatches() const
+{
+    return numLateBatches;
+}
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    DeckRenderPool.h
+    Created: 17 Sep 2022 3:08:14pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioProfiler.h"
+
+//==============================================================================
+/*
+    Spreads the decks of one audio callback over a few worker threads.
+
+    The audio thread publishes a batch of jobs with a single atomic store, wakes
+    the workers (they sleep on their event between batches) and works on the
+    batch itself alongside them, claiming jobs one at a time. A job no worker has
+    claimed yet is rendered by the audio thread, so no job ever waits for a
+    worker to wake up, and the audio thread never waits on a lock.
+
+    A batch has a deadline, and the audio thread never waits past it: at the
+    deadline the jobs nobody has claimed are dropped from the batch, and the
+    ones still running carry on but are reported as late (the caller leaves
+    them out of this block, and must give them somewhere to write that it is
+    not reading). A job that is still running from an earlier batch is never
+    started twice.
+*/
+class DeckRenderPool
+{
+public:
+    //Work that can be done for any index of a batch, on any thread of the pool
+    class Task
+    {
+        public:
+            virtual ~Task() = default;
+            virtual void renderJob(int index) = 0;
+    };
+
+    explicit DeckRenderPool(int numWorkers);
+    ~DeckRenderPool();
+
+    //Run task for 0..numJobs-1 on the workers and the calling thread (audio thread only),
+    //returns once every job is finished or the deadline (in high resolution ticks) has passed
+    void run(Task& task, int numJobs, juce::int64 deadlineTicks);
+    //Bool function to check if a job of the last batch finished in time (audio thread only)
+    bool isFinished(int index) const;
+
+    int getNumWorkers() const;
+    //Number of batches that missed their deadline
+    int getNumLateBatches() const;
+
+    static constexpr int maxJobs = 16;
+
+private:
+    class Worker;
+
+    //Claim and run jobs of a batch until there is none left or the deadline has passed (any thread of the pool)
+    void runJobs(juce::uint32 batch, juce::int64 deadlineTicks);
+
+    juce::OwnedArray<Worker> workers;
+
+    //Batch number in the high 32 bits and the next unclaimed job in the low 32 bits
+    std::atomic<juce::uint64> work{ 0 };
+    std::atomic<int> numJobsInBatch{ 0 };
+    std::atomic<Task*> currentTask{ nullptr };
+    juce::uint32 batchCounter = 0;
+
+    //Per job: running right now, and the last batch it finished
+    std::atomic<bool> busy[maxJobs];
+    std::atomic<juce::uint32> finishedBatch[maxJobs];
+
+    std::atomic<int> numLateBatches{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckRenderPool)
+};
@@ -0,0 +1,815 @@
+/*
+  ==============================================================================
+
+    DeckTransport.cpp
+    Created: 11 Sep 2022 1:44:52pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "DeckTransport.h"
+
+DeckTransport::DeckTransport()
+{
+}
+
+DeckTransport::~DeckTransport()
+{
+    collectGarbage();
+    std::unique_ptr<Track> notPickedUp(pendingTrack.exchange(nullptr));
+    std::unique_ptr<Track> nextNotPickedUp(pendingNextTrack.exchange(nullptr));
+}
+
+//==============================================================================
+void DeckTransport::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    deviceSampleRate = sampleRate;
+    blockSize = samplesPerBlockExpected;
+
+    //Builds the kernel tables the first time, here rather than on the audio thread
+    ResamplingKernel::get(ResamplingKernel::lowQuality);
+
+    //Room for one chunk at full speed of a track at up to 8x the device rate, plus the interpolation taps
+    int capacity = (int) std::ceil(chunkSize * maxSpeed * 8.0) + 2 * ResamplingKernel::maxTaps;
+    for (auto* voice : { &current, &next })
+    {
+        voice->input.setSize(2, capacity);
+        voice->input.clear();
+        voice->inputStart = 0;
+        voice->inputCount = 0;
+
+        if (voice->track != nullptr)
+        {
+            prepareTrack(*voice->track);
+        }
+    }
+}
+
+void DeckTransport::releaseResources()
+{
+    for (auto* voice : { &current, &next })
+    {
+        if (voice->track != nullptr)
+        {
+            voice->track->source->releaseResources();
+        }
+    }
+}
+
+void DeckTransport::prepareTrack(Track& track) const
+{
+    //The source is read at its own rate, in chunks of up to the whole input buffer
+    track.source->prepareToPlay(juce::jmax(blockSize, current.input.getNumSamples()), track.sampleRate);
+
+    //A streamed track keeps the samples of its loop in memory, allocated here rather than on the audio thread
+    if (!track.inMemory && track.loopBuffer.getNumSamples() == 0)
+    {
+        track.loopBuffer.setSize(2, (int) std::ceil(maxLoopSeconds * track.sampleRate));
+    }
+}
+
+void DeckTransport::setTrack(std::unique_ptr<Track> newTrack)
+{
+    collectGarbage();
+
+    //A track the audio thread has not picked up yet is simply replaced
+    std::unique_ptr<Track> notPickedUp(pendingTrack.exchange(newTrack.release()));
+}
+
+void DeckTransport::setNextTrack(std::unique_ptr<Track> newTrack)
+{
+    collectGarbage();
+
+    std::unique_ptr<Track> notPickedUp(pendingNextTrack.exchange(newTrack.release()));
+}
+
+void DeckTransport::collectGarbage()
+{
+    const juce::ScopedLock sl(garbageLock);
+
+    int start1, size1, start2, size2;
+    retireFifo.prepareToRead(retireFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+    {
+        std::unique_ptr<Track> oldTrack(retireQueue[start1 + i]);
+    }
+    for (int i = 0; i < size2; ++i)
+    {
+        std::unique_ptr<Track> oldTrack(retireQueue[start2 + i]);
+    }
+
+    retireFifo.finishedRead(size1 + size2);
+}
+
+bool DeckTransport::pushCommand(const Command& command)
+{
+    int start1, size1, start2, size2;
+    commandFifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 == 0)
+    {
+        return false;
+    }
+
+    commandQueue[start1] = command;
+    commandFifo.finishedWrite(1);
+    return true;
+}
+
+bool DeckTransport::popEvent(Event& event)
+{
+    int start1, size1, start2, size2;
+    eventFifo.prepareToRead(1, start1, size1, start2, size2);
+    if (size1 == 0)
+    {
+        return false;
+    }
+
+    event = eventQueue[start1];
+    eventFifo.finishedRead(1);
+    return true;
+}
+
+void DeckTransport::setLooping(bool shouldLoop)
+{
+    looping = shouldLoop;
+}
+
+bool DeckTransport::isLooping() const
+{
+    return looping;
+}
+
+void DeckTransport::setOverlap(double seconds)
+{
+    overlapSeconds = juce::jmax(0.0, seconds);
+}
+
+double DeckTransport::getOverlap() const
+{
+    return overlapSeconds;
+}
+
+void DeckTransport::setQuality(ResamplingKernel::Quality newQuality)
+{
+    quality = (int) newQuality;
+}
+
+ResamplingKernel::Quality DeckTransport::getQuality() const
+{
+    return (ResamplingKernel::Quality) quality.load();
+}
+
+double DeckTransport::getPositionInSeconds() const
+{
+    return publishedPosition;
+}
+
+double DeckTransport::getLoopInSeconds() const
+{
+    return publishedLoopIn;
+}
+
+double DeckTransport::getLoopOutSeconds() const
+{
+    return publishedLoopOut;
+}
+
+bool DeckTransport::isInLoop() const
+{
+    return publishedInLoop;
+}
+
+double DeckTransport::getLengthInSeconds() const
+{
+    return publishedLength;
+}
+
+bool DeckTransport::isPlaying() const
+{
+    return publishedPlaying;
+}
+
+bool DeckTransport::hasStreamFinished() const
+{
+    return publishedFinished;
+}
+
+juce::int64 DeckTransport::getRenderPosition() const
+{
+    return publishedClock;
+}
+
+//==============================================================================
+void DeckTransport::render(juce::AudioBuffer<float>& buffer,
+                           int startSample,
+                           int numSamples,
+                           juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>& speed)
+{
+    OTODESKS_PROFILE_SCOPE("DeckTransport::render");
+
+    adoptPendingTrack();
+    takeCommands();
+
+    if (current.input.getNumSamples() == 0)   //Not prepared yet
+    {
+        buffer.clear(startSample, numSamples);
+        return;
+    }
+
+    int done = 0;
+    while (done < numSamples)
+    {
+        //Run every command that is due at this exact sample
+        while (numScheduled > 0 && scheduled[0].renderSample <= renderClock)
+        {
+            Command command = scheduled[0];
+            for (int i = 1; i < numScheduled; ++i)
+            {
+                scheduled[i - 1] = scheduled[i];
+            }
+            --numScheduled;
+
+            executeCommand(command);
+        }
+
+        //Render up to the next scheduled command (or the end of the block)
+        int numToRender = numSamples - done;
+        if (numScheduled > 0)
+        {
+            numToRender = (int) juce::jmin((juce::int64) numToRender, scheduled[0].renderSample - renderClock);
+        }
+
+        renderRun(buffer, startSample + done, numToRender, speed);
+        done += numToRender;
+        renderClock += numToRender;
+    }
+
+    publishState();
+}
+
+void DeckTransport::renderRun(juce::AudioBuffer<float>& buffer,
+                              int startSample,
+                              int numSamples,
+                              juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>& speed)
+{
+    int numChannels = buffer.getNumChannels();
+    double stepLimit = current.input.getNumSamples() - 2.0 * ResamplingKernel::maxTaps;
+    auto& kernel = ResamplingKernel::get((ResamplingKernel::Quality) quality.load());
+    int tapsBefore = kernel.getTapsBefore();
+    int tapsAfter = kernel.getTapsAfter();
+
+    int done = 0;
+    while (done < numSamples)
+    {
+        if (!playing || current.track == nullptr)   //Stopped, the rest is silence
+        {
+            buffer.clear(startSample + done, numSamples - done);
+            speed.skip(numSamples - done);
+            return;
+        }
+
+        //Track samples per output sample at the fastest speed this chunk can reach
+        //(capped so one step always fits in the input buffer)
+        double fastest = juce::jmax(speed.getCurrentValue(), speed.getTargetValue());
+        double rateRatio = current.track->sampleRate / deviceSampleRate;
+        double maxStep = juce::jmin(stepLimit, fastest * rateRatio);
+        double nextRateRatio = next.track != nullptr ? next.track->sampleRate / deviceSampleRate : 0.0;
+        double maxNextStep = juce::jmin(stepLimit, fastest * nextRateRatio);
+        int maxChunk = juce::jmax(1, (int) ((current.input.getNumSamples() - 2 * ResamplingKernel::maxTaps) / juce::jmax(1.0, juce::jmax(maxStep, maxNextStep))));
+        int chunk = juce::jmin(chunkSize, numSamples - done, maxChunk);
+
+        //The anti-aliasing of the kernel follows the step (it only changes between chunks)
+        int band = kernel.getBand(maxStep);
+        int nextBand = kernel.getBand(maxNextStep);
+
+        fillInput(current, (juce::int64) std::floor(current.readPos) - tapsBefore, (juce::int64) std::floor(current.readPos + chunk * maxStep) + tapsAfter);
+
+        auto length = (double) current.track->length;
+        bool canLoop = looping && length > 0;
+
+        bool inLoop = loop.active;
+        auto loopStart = (double) loop.start;
+        auto loopEnd = (double) loop.end;
+
+        //The overlap with the next track starts this far into the current one (in its own samples)
+        bool hasNext = next.track != nullptr && !canLoop && !inLoop;
+        double fadeStart = length - overlapSeconds * current.track->sampleRate;
+        double fadeLength = length - fadeStart;
+        bool fading = hasNext && fadeLength > 0 && current.readPos + chunk * maxStep >= fadeStart;
+        if (fading)
+        {
+            fillInput(next, (juce::int64) std::floor(next.readPos) - tapsBefore, (juce::int64) std::floor(next.readPos + chunk * maxNextStep) + tapsAfter);
+        }
+
+        const float* in[2] = { current.input.getReadPointer(0), current.input.getReadPointer(1) };
+        const float* nextIn[2] = { next.input.getReadPointer(0), next.input.getReadPointer(1) };
+        juce::int64 firstSample = renderClock + done;
+
+        int i = 0;
+        for (; i < chunk; ++i)
+        {
+            //Loop out point, back to the in point exactly at this output sample (the input wraps with it)
+            if (inLoop && current.readPos >= loopEnd)
+            {
+                current.readPos = loopStart + std::fmod(current.readPos - loopStart, loopEnd - loopStart);
+                pushEvent(Event::looped, firstSample + i, current.readPos);
+                break;
+            }
+
+            //End of the track, exactly at this output sample
+            if (current.readPos >= length)
+            {
+                if (canLoop)
+                {
+                    seek(std::fmod(current.readPos, length));
+                    pushEvent(Event::looped, firstSample + i, current.readPos);
+                }
+                else if (hasNext && retireFifo.getFreeSpace() > 0)
+                {
+                    //The next track carries on from this very sample, no gap
+                    advance();
+                    pushEvent(Event::trackAdvanced, firstSample + i, current.readPos);
+                }
+                else
+                {
+                    playing = false;
+                    finished = true;
+                    pushEvent(Event::endOfStream, firstSample + i, length);
+                }
+                break;
+            }
+
+            auto index = (juce::int64) current.readPos;
+            int k = (int) (index - current.inputStart);
+            float t = (float) (current.readPos - (double) index);
+
+            //Both channels in one pass over the taps
+            float out[2];
+            kernel.interpolate(in[0] + k, in[1] + k, t, band, out[0], out[1]);
+
+            if (fading && current.readPos >= fadeStart)
+            {
+                //Equal-power overlap: the two gains always add up to constant power
+                auto progress = (float) ((current.readPos - fadeStart) / fadeLength);
+                float outGain = std::cos(progress * juce::MathConstants<float>::halfPi);
+                float inGain = std::sin(progress * juce::MathConstants<float>::halfPi);
+
+                auto nextIndex = (juce::int64) next.readPos;
+                int nextK = (int) (nextIndex - next.inputStart);
+                float nextT = (float) (next.readPos - (double) nextIndex);
+
+                float nextOut[2];
+                kernel.interpolate(nextIn[0] + nextK, nextIn[1] + nextK, nextT, nextBand, nextOut[0], nextOut[1]);
+                out[0] = outGain * out[0] + inGain * nextOut[0];
+                out[1] = outGain * out[1] + inGain * nextOut[1];
+            }
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                buffer.getWritePointer(ch, startSample + done)[i] = out[juce::jmin(ch, 1)];
+            }
+
+            double previousPos = current.readPos;
+            float step = speed.getNextValue();
+            current.readPos += juce::jmin(stepLimit, step * rateRatio);
+            if (fading && previousPos >= fadeStart)
+            {
+                next.readPos += juce::jmin(stepLimit, step * nextRateRatio);
+            }
+
+            //Cue point crossed, the next output sample is the first one at or past it
+            if (cuePos > 0 && previousPos < cuePos && current.readPos >= cuePos)
+            {
+                pushEvent(Event::cuePoint, firstSample + i + 1, cuePos);
+            }
+        }
+
+        done += i;
+    }
+}
+
+void DeckTransport::fillInput(Voice& voice, juce::int64 first, juce::int64 last)
+{
+    juce::int64 end = voice.inputStart + voice.inputCount;
+    if (first >= voice.inputStart && last < end)   //Already there
+    {
+        return;
+    }
+
+    if (first >= voice.inputStart && first < end)
+    {
+        //Keep the samples that are still needed and move them to the front
+        int offset = (int) (first - voice.inputStart);
+        int numToKeep = voice.inputCount - offset;
+        for (int ch = 0; ch < voice.input.getNumChannels(); ++ch)
+        {
+            auto* data = voice.input.getWritePointer(ch);
+            std::memmove(data, data + offset, (size_t) numToKeep * sizeof(float));
+        }
+        voice.inputStart = first;
+        voice.inputCount = numToKeep;
+    }
+    else   //Jumped somewhere else, start over
+    {
+        voice.inputStart = first;
+        voice.inputCount = 0;
+    }
+
+    int numToRead = (int) (last + 1 - (voice.inputStart + voice.inputCount));
+    readTrack(voice, voice.inputStart + voice.inputCount, voice.inputCount, numToRead);
+    voice.inputCount += numToRead;
+}
+
+void DeckTransport::readTrack(Voice& voice, juce::int64 trackSample, int destSample, int numSamples)
+{
+    if (&voice != &current || !loop.active)
+    {
+        readSpan(voice, trackSample, destSample, numSamples);
+        return;
+    }
+
+    //Past the out point the loop starts again, and so does what comes before the in point once inside the loop
+    juce::int64 loopLength = loop.end - loop.start;
+    bool insideLoop = current.readPos >= (double) loop.start;
+    while (numSamples > 0)
+    {
+        juce::int64 position = trackSample;
+        if (trackSample >= loop.end || (insideLoop && trackSample < loop.start))
+        {
+            position = loop.start + ((trackSample - loop.start) % loopLength + loopLength) % loopLength;
+        }
+
+        int numToRead = (int) juce::jmin((juce::int64) numSamples, loop.end - position);
+        readSpan(voice, position, destSample, numToRead);
+        trackSample += numToRead;
+        destSample += numToRead;
+        numSamples -= numToRead;
+    }
+}
+
+void DeckTransport::readSpan(Voice& voice, juce::int64 trackSample, int destSample, int numSamples)
+{
+    //Silence before the start of the track
+    if (trackSample < 0)
+    {
+        int numBefore = (int) juce::jmin((juce::int64) numSamples, -trackSample);
+        voice.input.clear(destSample, numBefore);
+        trackSample += numBefore;
+        destSample += numBefore;
+        numSamples -= numBefore;
+    }
+
+    //Samples of the loop that are in memory already
+    auto& loopBuffer = voice.track->loopBuffer;
+    auto loopOffset = trackSample - loop.start;
+    if (&voice == &current && loop.start >= 0 && loopOffset >= 0 && loopOffset < loop.recorded && numSamples > 0)
+    {
+        int numInMemory = (int) juce::jmin((juce::int64) numSamples, loop.recorded - loopOffset);
+        for (int ch = 0; ch < voice.input.getNumChannels(); ++ch)
+        {
+            voice.input.copyFrom(ch, destSample, loopBuffer, ch, (int) loopOffset, numInMemory);
+        }
+        trackSample += numInMemory;
+        destSample += numInMemory;
+        numSamples -= numInMemory;
+    }
+
+    //The track itself, read in order so read-ahead and decoders stay sequential
+    int numInTrack = (int) juce::jlimit((juce::int64) 0, (juce::int64) numSamples, voice.track->length - trackSample);
+    if (numInTrack > 0)
+    {
+        auto* source = voice.track->source.get();
+        if (source->getNextReadPosition() != trackSample)
+        {
+            source->setNextReadPosition(trackSample);
+        }
+        OTODESKS_PROFILE_SCOPE("DeckTransport::readSource");
+        source->getNextAudioBlock(juce::AudioSourceChannelInfo(&voice.input, destSample, numInTrack));
+
+        //Keep what carries on from the loop in point (a streamed track, read in order)
+        if (&voice == &current && loop.start >= 0 && trackSample == loop.start + loop.recorded)
+        {
+            int numToKeep = juce::jmin(numInTrack, loopBuffer.getNumSamples() - loop.recorded);
+            for (int ch = 0; ch < voice.input.getNumChannels() && numToKeep > 0; ++ch)
+            {
+                loopBuffer.copyFrom(ch, loop.recorded, voice.input, ch, destSample, numToKeep);
+            }
+            loop.recorded += juce::jmax(0, numToKeep);
+        }
+    }
+
+    //Silence after the end of the track
+    if (numSamples > numInTrack)
+    {
+        voice.input.clear(destSample + numInTrack, numSamples - numInTrack);
+    }
+}
+
+//==============================================================================
+bool DeckTransport::retire(std::unique_ptr<Track>& track)
+{
+    if (track == nullptr)
+    {
+        return true;
+    }
+
+    int start1, size1, start2, size2;
+    retireFifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 == 0)
+    {
+        return false;
+    }
+
+    retireQueue[start1] = track.release();
+    retireFifo.finishedWrite(1);
+    return true;
+}
+
+void DeckTransport::advance()
+{
+    //The voices swap places (buffers included, nothing is allocated), the old track goes to be freed
+    std::swap(current, next);
+    retire(next.track);
+    resetVoice(next);
+    loop = Loop();
+
+    cuePos = 0;
+    finished = false;
+}
+
+void DeckTransport::resetVoice(Voice& voice)
+{
+    voice.readPos = 0;
+    voice.inputStart = 0;
+    voice.inputCount = 0;
+}
+
+void DeckTransport::adoptPendingTrack()
+{
+    //Wait until there is room to hand the old track back, the audio thread never deletes anything
+    if (retireFifo.getFreeSpace() == 0)
+    {
+        return;
+    }
+
+    if (auto* newTrack = pendingTrack.exchange(nullptr))
+    {
+        retire(current.track);
+        current.track.reset(newTrack);
+        resetVoice(current);
+        loop = Loop();
+
+        cuePos = 0;
+        finished = false;
+        playing = current.track->startPlaying;
+
+        pushEvent(Event::trackStarted, renderClock, 0);
+        if (playing)
+        {
+            pushEvent(Event::played, renderClock, 0);
+        }
+    }
+
+    if (retireFifo.getFreeSpace() == 0)
+    {
+        return;
+    }
+
+    if (auto* newNextTrack = pendingNextTrack.exchange(nullptr))
+    {
+        retire(next.track);
+        next.track.reset(newNextTrack);
+        resetVoice(next);
+    }
+}
+
+void DeckTransport::takeCommands()
+{
+    Command command;
+    int start1, size1, start2, size2;
+
+    for (;;)
+    {
+        commandFifo.prepareToRead(1, start1, size1, start2, size2);
+        if (size1 == 0)
+        {
+            return;
+        }
+        command = commandQueue[start1];
+        commandFifo.finishedRead(1);
+
+        //Commands for now (or the past) run at the start of this block
+        if (command.renderSample < renderClock)
+        {
+            command.renderSample = renderClock;
+        }
+
+        if (numScheduled == maxScheduled)   //No room left to wait, run it now rather than lose it
+        {
+            executeCommand(command);
+            continue;
+        }
+
+        //Keep the list sorted, commands for the same sample run in the order they were sent
+        int i = numScheduled;
+        while (i > 0 && scheduled[i - 1].renderSample > command.renderSample)
+        {
+            scheduled[i] = scheduled[i - 1];
+            --i;
+        }
+        scheduled[i] = command;
+        ++numScheduled;
+    }
+}
+
+void DeckTransport::executeCommand(const Command& command)
+{
+    double trackRate = current.track != nullptr ? current.track->sampleRate : deviceSampleRate;
+
+    switch (command.type)
+    {
+        case Command::play:
+            if (current.track != nullptr && !finished)
+            {
+                playing = true;
+                pushEvent(Event::played, renderClock, current.readPos);
+            }
+            break;
+
+        case Command::stop:
+            if (playing)
+            {
+                playing = false;
+                pushEvent(Event::stopped, renderClock, current.readPos);
+            }
+            break;
+
+        case Command::cue:
+            seek(cuePos);
+            playing = false;
+            pushEvent(Event::jumped, renderClock, current.readPos);
+            break;
+
+        case Command::setCue:
+            cuePos = juce::jmax(0.0, command.position * trackRate);
+            break;
+
+        case Command::jump:
+            seek(command.position * trackRate);
+            pushEvent(Event::jumped, renderClock, current.readPos);
+            break;
+
+        case Command::dropNext:
+            if (retire(next.track))
+            {
+                resetVoice(next);
+            }
+            break;
+
+        case Command::loopIn:
+            if (current.track != nullptr)
+            {
+                leaveLoop();
+                recordFrom((juce::int64) std::floor(current.readPos));
+                loop.end = -1;
+            }
+            break;
+
+        case Command::loopOut:
+            if (loop.start >= 0)
+            {
+                setLoop(loop.start, (juce::int64) std::floor(current.readPos));
+            }
+            break;
+
+        case Command::loopLength:
+        {
+            //A loop that is playing keeps its in point and changes length
+            auto start = loop.active ? loop.start : (juce::int64) std::floor(current.readPos);
+            setLoop(start, start + (juce::int64) std::llround(command.position * trackRate));
+            break;
+        }
+
+        case Command::reloop:
+            if (!loop.active && loop.start >= 0 && loop.end > loop.start)
+            {
+                setLoop(loop.start, loop.end);
+            }
+            break;
+
+        case Command::exitLoop:
+            leaveLoop();
+            break;
+    }
+}
+
+void DeckTransport::setLoop(juce::int64 start, juce::int64 end)
+{
+    if (current.track == nullptr)
+    {
+        return;
+    }
+
+    end = juce::jmin(end, current.track->length);
+    if (start < 0 || end - start < minLoopLength)
+    {
+        return;
+    }
+
+    leaveLoop();
+    if (start != loop.start)
+    {
+        recordFrom(start);
+    }
+    loop.end = end;
+    loop.active = true;
+
+    //Past the out point the input has to be read again, wrapped
+    trimInput(end);
+}
+
+void DeckTransport::leaveLoop()
+{
+    if (!loop.active)
+    {
+        return;
+    }
+
+    //What the input holds past the out point is the start of the loop, the track carries on from the loop buffer.
+    //Right after a wrap the few samples before the in point are the end of the loop, they are what was just played
+    trimInput(loop.end);
+    loop.active = false;
+}
+
+void DeckTransport::recordFrom(juce::int64 start)
+{
+    loop.start = start;
+    loop.recorded = 0;
+
+    //What the input holds from the in point on is where the recording starts (the source is already past it)
+    auto& loopBuffer = current.track->loopBuffer;
+    auto offset = start - current.inputStart;
+    if (offset >= 0 && offset < current.inputCount)
+    {
+        int numToKeep = juce::jmin(current.inputCount - (int) offset, loopBuffer.getNumSamples());
+        for (int ch = 0; ch < current.input.getNumChannels() && numToKeep > 0; ++ch)
+        {
+            loopBuffer.copyFrom(ch, 0, current.input, ch, (int) offset, numToKeep);
+        }
+        loop.recorded = juce::jmax(0, numToKeep);
+    }
+}
+
+void DeckTransport::trimInput(juce::int64 end)
+{
+    current.inputCount = (int) juce::jlimit((juce::int64) 0, (juce::int64) current.inputCount, end - current.inputStart);
+}
+
+void DeckTransport::seek(double trackSample)
+{
+    double length = current.track != nullptr ? (double) current.track->length : 0.0;
+    current.readPos = juce::jlimit(0.0, length, trackSample);
+
+    //Jumping out of a loop leaves it
+    if (loop.active && (current.readPos < (double) loop.start || current.readPos >= (double) loop.end))
+    {
+        leaveLoop();
+    }
+
+    finished = current.readPos >= length && !looping;
+
+    //An overlap that was under way starts again from the top of the next track
+    next.readPos = 0;
+}
+
+void DeckTransport::pushEvent(Event::Type type, juce::int64 renderSample, double trackSample)
+{
+    int start1, size1, start2, size2;
+    eventFifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 == 0)   //Nobody is reading, drop it
+    {
+        return;
+    }
+
+    eventQueue[start1].type = type;
+    eventQueue[start1].renderSample = renderSample;
+    eventQueue[start1].trackSample = (juce::int64) trackSample;
+    eventFifo.finishedWrite(1);
+}
+
+void DeckTransport::publishState()
+{
+    if (current.track != nullptr)
+    {
+        publishedPosition = current.readPos / current.track->sampleRate;
+        publishedLength = (double) current.track->length / current.track->sampleRate;
+        publishedLoopIn = loop.start >= 0 ? (double) loop.start / current.track->sampleRate : -1.0;
+        publishedLoopOut = loop.end > loop.start ? (double) loop.end / current.track->sampleRate : -1.0;
+    }
+    publishedInLoop = loop.active;
+    publishedPlaying = playing;
+    publishedFinished = finished;
+    publishedClock = renderClock;
+}
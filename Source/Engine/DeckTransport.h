@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+    DeckTransport.h
+    Created: 11 Sep 2022 1:44:52pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioProfiler.h"
+#include "ResamplingKernel.h"
+
+//==============================================================================
+/*
+    The play head of a deck. It runs on the audio thread: it reads the track,
+    converts it to the device rate at the current speed in a single
+    interpolation step (see ResamplingKernel) and keeps the exact track
+    position of every output sample.
+
+    Everything that crosses threads is lock-free:
+     - tracks are handed over with setTrack() and picked up at the next block,
+     - a next track can be handed over with setNextTrack(), it takes over at the
+       exact output sample where the current one ends (with an optional
+       equal-power overlap), so autoplay has no gap,
+     - commands (play, stop, cue, jump, loops) go in through a FIFO and can be
+       scheduled for a future sample of the deck's output clock,
+     - events (end of stream, loop point, cue point) come out through a FIFO,
+       stamped with the output sample and track sample where they happened.
+
+    Loops (in / out points or a length from the read position) wrap at the exact
+    output sample where the read position reaches their out point. The samples
+    of a loop are served from memory: a track from the decoded cache is in
+    memory already, a streamed one keeps what it reads from the loop in point
+    on in its loop buffer (up to maxLoopSeconds). Engaging, resizing or leaving
+    a loop moves no read position of the source, so it never seeks the disk.
+*/
+class DeckTransport
+{
+public:
+    //A track ready to be played, built off the audio thread
+    struct Track
+    {
+        std::unique_ptr<juce::PositionableAudioSource> source;
+        double sampleRate = 44100.0;
+        juce::int64 length = 0;
+        //Start playing as soon as the audio thread picks the track up
+        bool startPlaying = false;
+        //The source is decoded in memory (no loop buffer needed)
+        bool inMemory = false;
+        //What has been read from the loop in point on, for a streamed track (allocated by prepareTrack)
+        juce::AudioBuffer<float> loopBuffer;
+    };
+
+    //Something that happened on the audio thread
+    struct Event
+    {
+        enum Type
+        {
+            trackStarted,   //a new track has been swapped in
+            played,
+            stopped,
+            endOfStream,
+            looped,
+            cuePoint,
+            jumped,
+            trackAdvanced   //the next track has taken over from the current one
+        };
+
+        Type type = trackStarted;
+        //Sample of the deck's output clock where it happened
+        juce::int64 renderSample = 0;
+        //Position in the track (in samples of the track) where it happened
+        juce::int64 trackSample = 0;
+    };
+
+    //Something to do on the audio thread, now or at a given sample of the output clock
+    struct Command
+    {
+        enum Type
+        {
+            play,
+            stop,
+            cue,        //jump back to the cue point and stop
+            setCue,     //set the cue point at position
+            jump,       //jump to position
+            dropNext,   //forget the next track
+            loopIn,     //set the loop in point at the read position
+            loopOut,    //set the loop out point at the read position and start looping
+            loopLength, //loop position seconds from the loop in point (from the read position if not looping)
+            reloop,     //loop the last loop again
+            exitLoop    //carry on past the loop out point
+        };
+
+        Type type = play;
+        //Output clock sample to run it at (-1 runs it at the start of the next block)
+        juce::int64 renderSample = -1;
+        //Track position in seconds (setCue and jump), length in seconds (loopLength)
+        double position = 0;
+    };
+
+    //Longest loop kept in memory for a streamed track (a longer one reads its tail from the source)
+    static constexpr double maxLoopSeconds = 16.0;
+    //Shortest loop (in track samples)
+    static constexpr int minLoopLength = 64;
+
+    DeckTransport();
+    ~DeckTransport();
+
+    //Allocates, so it is never called while the audio callback is running
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
+
+    //Prepare the source of a track before it is handed over (any thread but the audio thread)
+    void prepareTrack(Track& track) const;
+    //Hand a new track to the audio thread (any thread but the audio thread)
+    void setTrack(std::unique_ptr<Track> newTrack);
+    //Hand the track that follows the current one to the audio thread (any thread but the audio thread)
+    void setNextTrack(std::unique_ptr<Track> newTrack);
+    //Free tracks the audio thread has swapped out (any thread but the audio thread, one at a time under garbageLock)
+    void collectGarbage();
+
+    //Queue a command (message thread only), returns false if the queue is full
+    bool pushCommand(const Command& command);
+    //Take the next event (message thread only), returns false if there is none
+    bool popEvent(Event& event);
+
+    //Loop the whole track instead of stopping at its end
+    void setLooping(bool shouldLoop);
+    bool isLooping() const;
+
+    //Length (in secs of the ending track) of the equal-power overlap with the next track, 0 is a straight cut
+    void setOverlap(double seconds);
+    double getOverlap() const;
+
+    //Interpolation the track is read with (taken up at the next block)
+    void setQuality(ResamplingKernel::Quality newQuality);
+    ResamplingKernel::Quality getQuality() const;
+
+    //State published by the audio thread at the end of every block
+    double getPositionInSeconds() const;
+    //Loop in and out points in secs (-1 when not set) and whether the loop is playing
+    double getLoopInSeconds() const;
+    double getLoopOutSeconds() const;
+    bool isInLoop() const;
+    double getLengthInSeconds() const;
+    bool isPlaying() const;
+    bool hasStreamFinished() const;
+    //Number of samples the deck has rendered since it was prepared (its output clock)
+    juce::int64 getRenderPosition() const;
+
+    //Render the next block of the deck at the given (smoothed) speed, audio thread only
+    void render(juce::AudioBuffer<float>& buffer,
+                int startSample,
+                int numSamples,
+                juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>& speed);
+
+private:
+    //A track being read, with the track samples around its read position (for interpolation)
+    struct Voice
+    {
+        std::unique_ptr<Track> track;
+        double readPos = 0;
+        juce::AudioBuffer<float> input;
+        juce::int64 inputStart = 0;
+        int inputCount = 0;
+    };
+
+    //Render numSamples without any command in between
+    void renderRun(juce::AudioBuffer<float>& buffer,
+                   int startSample,
+                   int numSamples,
+                   juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>& speed);
+    //Make sure track samples [first, last] are in the voice's input buffer
+    void fillInput(Voice& voice, juce::int64 first, juce::int64 last);
+    //Read track samples into the voice's input buffer (the current track wraps inside an active loop)
+    void readTrack(Voice& voice, juce::int64 trackSample, int destSample, int numSamples);
+    //Read track samples as they are in the track (silence outside it), the loop buffer first
+    void readSpan(Voice& voice, juce::int64 trackSample, int destSample, int numSamples);
+    //Forget the input samples from end on (they wrapped around a loop that has changed)
+    void trimInput(juce::int64 end);
+    //Start looping from start to end, or stop looping
+    void setLoop(juce::int64 start, juce::int64 end);
+    void leaveLoop();
+    //Set the loop in point and keep the input from it on as the start of the loop buffer
+    void recordFrom(juce::int64 start);
+
+    //Hand a track over to be freed off the audio thread, returns false if there is no room left
+    bool retire(std::unique_ptr<Track>& track);
+    //Let the next track take over from the current one
+    void advance();
+
+    void adoptPendingTrack();
+    void takeCommands();
+    void executeCommand(const Command& command);
+    void seek(double trackSample);
+    void resetVoice(Voice& voice);
+    void pushEvent(Event::Type type, juce::int64 renderSample, double trackSample);
+    void publishState();
+
+    //Tracks: the audio thread owns the voices, pending tracks and retired ones go through hand-over slots
+    Voice current;
+    Voice next;
+    std::atomic<Track*> pendingTrack{ nullptr };
+    std::atomic<Track*> pendingNextTrack{ nullptr };
+
+    static constexpr int retireQueueSize = 8;
+    juce::AbstractFifo retireFifo{ retireQueueSize };
+    Track* retireQueue[retireQueueSize] = {};
+    //The loader threads and the message thread all free retired tracks, the fifo has a single reader
+    juce::CriticalSection garbageLock;
+
+    //Audio thread state
+    double deviceSampleRate = 44100.0;
+    int blockSize = 512;
+    bool playing = false;
+    bool finished = false;
+    double cuePos = 0;
+    juce::int64 renderClock = 0;
+    std::atomic<bool> looping{ false };
+    std::atomic<double> overlapSeconds{ 0 };
+    std::atomic<int> quality{ ResamplingKernel::mediumQuality };
+
+    //Loop of the current track (audio thread only), the loop buffer holds recorded samples from start on
+    struct Loop
+    {
+        juce::int64 start = -1;
+        juce::int64 end = -1;
+        bool active = false;
+        int recorded = 0;
+    };
+    Loop loop;
+
+    //Commands waiting for their output sample (audio thread only, kept sorted)
+    static constexpr int maxScheduled = 64;
+    Command scheduled[maxScheduled];
+    int numScheduled = 0;
+
+    //Lock-free queues between the message thread and the audio thread
+    static constexpr int queueSize = 256;
+    juce::AbstractFifo commandFifo{ queueSize };
+    Command commandQueue[queueSize];
+    juce::AbstractFifo eventFifo{ queueSize };
+    Event eventQueue[queueSize];
+
+    //Published state
+    std::atomic<double> publishedPosition{ 0 };
+    std::atomic<double> publishedLength{ 0 };
+    std::atomic<bool> publishedPlaying{ false };
+    std::atomic<bool> publishedFinished{ false };
+    std::atomic<juce::int64> publishedClock{ 0 };
+    std::atomic<double> publishedLoopIn{ -1 };
+    std::atomic<double> publishedLoopOut{ -1 };
+    std::atomic<bool> publishedInLoop{ false };
+
+    //Input samples read per interpolation chunk and the fastest supported speed
+    static constexpr int chunkSize = 32;
+    static constexpr double maxSpeed = 100.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckTransport)
+};
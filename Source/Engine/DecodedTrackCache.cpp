@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    DecodedTrackCache.cpp
+    Created: 8 Sep 2022 3:27:19pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "DecodedTrackCache.h"
+
+//==============================================================================
+DecodedTrack::DecodedTrack(int numChannels, int numSamples, double _sampleRate) : samples(numChannels, numSamples),
+                                                                                   sampleRate(_sampleRate)
+{
+}
+
+size_t DecodedTrack::getSizeInBytes() const
+{
+    return (size_t) samples.getNumChannels() * (size_t) samples.getNumSamples() * sizeof(float);
+}
+
+//==============================================================================
+class DecodedTrackCache::DecodeJob : public juce::ThreadPoolJob
+{
+public:
+    DecodeJob(DecodedTrackCache& _owner, const juce::URL& _audioURL) : juce::ThreadPoolJob("Decode " + _audioURL.getFileName()),
+                                                                       owner(_owner),
+                                                                       audioURL(_audioURL)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        AudioProfiler::nameThread("Track decoder");
+
+        auto key = getKey(audioURL);
+        DecodedTrack::Ptr track;
+        {
+            OTODESKS_PROFILE_SCOPE("DecodedTrackCache::decode");
+            track = owner.decode(audioURL, *this);
+        }
+
+        const juce::ScopedLock sl(owner.lock);
+        owner.decoding.erase(key);
+        if (track != nullptr)
+        {
+            owner.insert(key, track);
+        }
+        return jobHasFinished;
+    }
+
+private:
+    DecodedTrackCache& owner;
+    juce::URL audioURL;
+};
+
+//==============================================================================
+DecodedTrackCache::DecodedTrackCache(juce::AudioFormatManager& _formatManager, size_t _memoryBudget) : formatManager(_formatManager),
+                                                                                                     memoryBudget(_memoryBudget)
+{
+}
+
+DecodedTrackCache::~DecodedTrackCache()
+{
+    //Stop decodes that are still running before the cache goes away
+    decodePool.removeAllJobs(true, 4000);
+}
+
+void DecodedTrackCache::setMemoryBudget(size_t bytes)
+{
+    const juce::ScopedLock sl(lock);
+    memoryBudget = bytes;
+    evictOverBudget();
+}
+
+size_t DecodedTrackCache::getMemoryBudget() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryBudget;
+}
+
+size_t DecodedTrackCache::getMemoryUsed() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryUsed;
+}
+
+DecodedTrack::Ptr DecodedTrackCache::find(const juce::URL& audioURL)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto it = lookup.find(getKey(audioURL));
+    if (it == lookup.end())
+    {
+        return nullptr;
+    }
+
+    //Move it to the front (most recently used)
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->track;
+}
+
+void DecodedTrackCache::prefetch(const juce::URL& audioURL)
+{
+    if (audioURL.isEmpty())
+    {
+        return;
+    }
+
+    auto key = getKey(audioURL);
+    {
+        const juce::ScopedLock sl(lock);
+        if (lookup.count(key) != 0 || decoding.count(key) != 0)   //Cached or on its way
+        {
+            return;
+        }
+        decoding.insert(key);
+    }
+
+    decodePool.addJob(new DecodeJob(*this, audioURL), true);
+}
+
+DecodedTrack::Ptr DecodedTrackCache::decode(const juce::URL& audioURL, juce::ThreadPoolJob& job)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    if (auto stream = audioURL.createInputStream(false))
+    {
+        reader.reset(formatManager.createReaderFor(std::move(stream)));
+    }
+
+    if (reader == nullptr || reader->lengthInSamples <= 0)   //Bad file
+    {
+        return nullptr;
+    }
+
+    int numChannels = (int) juce::jmin(2u, reader->numChannels);
+    size_t bytes = (size_t) numChannels * (size_t) reader->lengthInSamples * sizeof(float);
+    if (bytes > getMemoryBudget() || reader->lengthInSamples > std::numeric_limits<int>::max())
+    {
+        std::cout << "DecodedTrackCache::decode " << audioURL.getFileName() << " does not fit in the memory budget" << std::endl;
+        return nullptr;
+    }
+
+    DecodedTrack::Ptr track = new DecodedTrack(numChannels, (int) reader->lengthInSamples, reader->sampleRate);
+
+    //Decode in chunks so the job can be cancelled quickly
+    const int chunkSize = 65536;
+    for (juce::int64 pos = 0; pos < reader->lengthInSamples; pos += chunkSize)
+    {
+        if (job.shouldExit())
+        {
+            return nullptr;
+        }
+
+        int numSamples = (int) juce::jmin((juce::int64) chunkSize, reader->lengthInSamples - pos);
+        reader->read(&track->samples, (int) pos, numSamples, pos, true, true);
+    }
+
+    return track;
+}
+
+void DecodedTrackCache::insert(const std::string& key, DecodedTrack::Ptr track)
+{
+    if (lookup.count(key) != 0)
+    {
+        return;
+    }
+
+    entries.push_front({ key, track });
+    lookup[key] = entries.begin();
+    memoryUsed += track->getSizeInBytes();
+
+    evictOverBudget();
+}
+
+void DecodedTrackCache::evictOverBudget()
+{
+    //Walk from the least recently used end, skipping tracks a deck is still holding
+    auto it = entries.end();
+    while (memoryUsed > memoryBudget && it != entries.begin())
+    {
+        --it;
+        if (it->track->getReferenceCount() > 1)
+        {
+            continue;
+        }
+
+        memoryUsed -= it->track->getSizeInBytes();
+        lookup.erase(it->key);
+        it = entries.erase(it);
+    }
+}
+
+std::string DecodedTrackCache::getKey(const juce::URL& audioURL)
+{
+    return audioURL.toString(false).toStdString();
+}
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    DecodedTrackCache.h
+    Created: 8 Sep 2022 3:27:19pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include "AudioProfiler.h"
+
+//==============================================================================
+/*
+    A track fully decoded to PCM in memory. Decks hold it through a Ptr, so a
+    track that is playing stays alive even if the cache evicts it.
+*/
+class DecodedTrack : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<DecodedTrack>;
+
+    DecodedTrack(int numChannels, int numSamples, double _sampleRate);
+
+    //Size of the decoded samples in bytes
+    size_t getSizeInBytes() const;
+
+    juce::AudioBuffer<float> samples;
+    double sampleRate;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedTrack)
+};
+
+//==============================================================================
+/*
+    LRU cache of decoded tracks shared by all decks, kept under a memory budget.
+    Tracks are decoded in the background with prefetch() so switching between
+    decked tracks never touches the disk.
+*/
+class DecodedTrackCache
+{
+public:
+    DecodedTrackCache(juce::AudioFormatManager& _formatManager, size_t _memoryBudget);
+    ~DecodedTrackCache();
+
+    //Set the memory budget in bytes (tracks in use by a deck are never evicted)
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const;
+    //Bytes currently held by the cache
+    size_t getMemoryUsed() const;
+
+    //Return the decoded track if it is cached (and mark it as recently used), nullptr otherwise
+    DecodedTrack::Ptr find(const juce::URL& audioURL);
+    //Decode a track on the background pool unless it is cached or already being decoded
+    void prefetch(const juce::URL& audioURL);
+
+private:
+    class DecodeJob;
+
+    struct Entry
+    {
+        std::string key;
+        DecodedTrack::Ptr track;
+    };
+
+    //Decode a whole track (on a pool thread), returns nullptr if it failed, was cancelled or is over budget
+    DecodedTrack::Ptr decode(const juce::URL& audioURL, juce::ThreadPoolJob& job);
+    //Add a decoded track to the cache and evict the least recently used ones over budget (lock held)
+    void insert(const std::string& key, DecodedTrack::Ptr track);
+    void evictOverBudget();
+
+    static std::string getKey(const juce::URL& audioURL);
+
+    juce::AudioFormatManager& formatManager;
+
+    juce::CriticalSection lock;
+    //Most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+    std::unordered_set<std::string> decoding;
+    size_t memoryBudget;
+    size_t memoryUsed = 0;
+
+    juce::ThreadPool decodePool{ 2 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedTrackCache)
+};
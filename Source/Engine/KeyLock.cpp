@@ -0,0 +1,228 @@
+/*
+  ==============================================================================
+
+    KeyLock.cpp
+    Created: 26 Sep 2022 11:18:40am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "KeyLock.h"
+
+KeyLock::KeyLock()
+{
+}
+
+KeyLock::~KeyLock()
+{
+}
+
+//==============================================================================
+void KeyLock::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    //24 ms grains overlapping by half, searched 6 ms either side
+    grainLength = 2 * juce::jmax(16, juce::roundToInt(0.012 * sampleRate));
+    hop = grainLength / 2;
+    searchRange = grainLength / 4;
+    searchStride = juce::jmax(1, 2 * searchRange / searchPoints);
+
+    //A grain read at the slowest speed (ratio 1 / minSpeed), shifted by the search, must be in the history already
+    latency = (int) std::ceil(grainLength * 0.5 + grainLength * 0.5 / minSpeed + searchRange + 4);
+
+    //Periodic Hann: windows a hop apart add up to exactly 1
+    window.resize((size_t) grainLength);
+    for (int i = 0; i < grainLength; ++i)
+    {
+        window[(size_t) i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * (float) i / (float) grainLength);
+    }
+
+    int historySize = juce::nextPowerOfTwo(latency + 3 * grainLength + samplesPerBlockExpected);
+    history.setSize(3, historySize);
+    historyMask = historySize - 1;
+
+    int outputSize = juce::nextPowerOfTwo(grainLength + samplesPerBlockExpected + hop);
+    output.setSize(2, outputSize);
+    outputMask = outputSize - 1;
+
+    maxBlockSize = juce::jmax(1, samplesPerBlockExpected);
+    reset();
+}
+
+void KeyLock::reset()
+{
+    history.clear();
+    output.clear();
+    numWritten = 0;
+    numRead = 0;
+    nextGrainTime = 0;
+    hasLastGrain = false;
+}
+
+int KeyLock::getLatencyInSamples() const
+{
+    return latency;
+}
+
+//==============================================================================
+void KeyLock::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, double speed)
+{
+    if (grainLength == 0 || buffer.getNumChannels() == 0)   //Not prepared yet
+    {
+        return;
+    }
+
+    //Grains are read at 1 / speed, which undoes the pitch shift of the varispeed transport
+    double ratio = 1.0 / juce::jlimit(minSpeed, maxSpeed, speed);
+    int numChannels = juce::jmin(buffer.getNumChannels(), 2);
+
+    //In pieces no longer than the accumulator was sized for
+    int done = 0;
+    while (done < numSamples)
+    {
+        int numToDo = juce::jmin(maxBlockSize, numSamples - done);
+        auto* left = buffer.getWritePointer(0, startSample + done);
+        auto* right = buffer.getWritePointer(numChannels - 1, startSample + done);
+
+        //Input history, with the mono sum the search runs on
+        auto* historyLeft = history.getWritePointer(0);
+        auto* historyRight = history.getWritePointer(1);
+        auto* historyMono = history.getWritePointer(2);
+        for (int i = 0; i < numToDo; ++i)
+        {
+            auto index = (int) ((numWritten + i) & historyMask);
+            historyLeft[index] = left[i];
+            historyRight[index] = right[i];
+            historyMono[index] = left[i] + right[i];
+        }
+        numWritten += numToDo;
+
+        //Every grain that starts before the end of this piece
+        while (nextGrainTime < numRead + numToDo)
+        {
+            addGrain(nextGrainTime, ratio);
+            nextGrainTime += hop;
+        }
+
+        //Hand the finished samples out and clear their slots for the grains to come
+        auto* outputLeft = output.getWritePointer(0);
+        auto* outputRight = output.getWritePointer(1);
+        for (int i = 0; i < numToDo; ++i)
+        {
+            auto index = (int) ((numRead + i) & outputMask);
+            left[i] = outputLeft[index];
+            right[i] = outputRight[index];
+            outputLeft[index] = 0.0f;
+            outputRight[index] = 0.0f;
+        }
+        numRead += numToDo;
+
+        done += numToDo;
+    }
+}
+
+//==============================================================================
+void KeyLock::addGrain(juce::int64 grainTime, double ratio)
+{
+    //Centre the grain on the input that was playing latency samples ago
+    auto nominalStart = (juce::int64) std::floor(grainTime + hop - latency - grainLength * ratio * 0.5);
+    auto start = findGrainStart(nominalStart);
+
+    auto* inLeft = history.getReadPointer(0);
+    auto* inRight = history.getReadPointer(1);
+    auto* outLeft = output.getWritePointer(0);
+    auto* outRight = output.getWritePointer(1);
+
+    for (int j = 0; j < grainLength; ++j)
+    {
+        double position = (double) start + j * ratio;
+        auto index = (juce::int64) std::floor(position);
+        auto t = (float) (position - (double) index);
+
+        int i0 = (int) ((index - 1) & historyMask);
+        int i1 = (int) (index & historyMask);
+        int i2 = (int) ((index + 1) & historyMask);
+        int i3 = (int) ((index + 2) & historyMask);
+
+        //4-point Hermite, both channels at once
+        auto hermite = [t](float xm1, float x0, float x1, float x2)
+        {
+            float c1 = 0.5f * (x1 - xm1);
+            float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+            float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+            return ((c3 * t + c2) * t + c1) * t + x0;
+        };
+
+        float w = window[(size_t) j];
+        int o = (int) ((grainTime + j) & outputMask);
+        outLeft[o] += w * hermite(inLeft[i0], inLeft[i1], inLeft[i2], inLeft[i3]);
+        outRight[o] += w * hermite(inRight[i0], inRight[i1], inRight[i2], inRight[i3]);
+    }
+
+    lastGrainStart = (double) start;
+    lastRatio = ratio;
+    hasLastGrain = true;
+}
+
+juce::int64 KeyLock::findGrainStart(juce::int64 nominalStart) const
+{
+    if (!hasLastGrain)
+    {
+        return nominalStart;
+    }
+
+    //Where the previous grain would carry on, the new grain should look like it there
+    auto continuation = (juce::int64) std::floor(lastGrainStart + hop * lastRatio);
+    auto* mono = history.getReadPointer(2);
+
+    //Normalised cross-correlation over the overlap, every step-th sample
+    auto similarity = [this, mono, continuation](juce::int64 candidate, int step)
+    {
+        float correlation = 0.0f;
+        float energy = 1.0e-9f;
+        for (int m = 0; m < hop; m += step)
+        {
+            float x = mono[(continuation + m) & historyMask];
+            float y = mono[(candidate + m) & historyMask];
+            correlation += x * y;
+            energy += y * y;
+        }
+        return correlation / std::sqrt(energy);
+    };
+
+    //Coarse search over the whole range, then every sample around the best one
+    juce::int64 best = nominalStart;
+    float bestScore = similarity(nominalStart, searchStride);
+    for (int offset = -searchRange; offset <= searchRange; offset += searchStride)
+    {
+        float score = similarity(nominalStart + offset, searchStride);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = nominalStart + offset;
+        }
+    }
+
+    if (searchStride > 1)
+    {
+        int fineStep = juce::jmax(1, searchStride / 2);
+        auto coarseBest = best;
+        bestScore = similarity(coarseBest, fineStep);
+        for (int offset = 1 - searchStride; offset < searchStride; ++offset)
+        {
+            if (offset == 0 || std::abs(coarseBest + offset - nominalStart) > searchRange)
+            {
+                continue;
+            }
+
+            float score = similarity(coarseBest + offset, fineStep);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                best = coarseBest + offset;
+            }
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    KeyLock.h
+    Created: 26 Sep 2022 11:18:40am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Keeps the key of a deck when its speed changes (WSOLA time-stretch).
+
+    The transport already plays the track at the new tempo, which also moves the
+    pitch by the speed ratio. KeyLock takes that output and moves the pitch back:
+    it overlap-adds Hann grains read from the recent output at 1 / speed, so the
+    tempo stays and the pitch returns to the original. Each grain starts where
+    it best matches the continuation of the previous one (a waveform similarity
+    search), which keeps transients and tones free of phasing.
+
+    The cost is fixed per output sample and does not depend on the music:
+     - two overlapping grains x two channels of 4-point interpolation,
+     - one similarity search per hop, decimated so that it is always about
+       2 x searchPoints x searchPoints multiply-adds whatever the sample rate.
+    That is roughly 200 flops per stereo output sample at 44.1 kHz, less at
+    higher rates. The latency is fixed as well (getLatencyInSamples, about
+    40 ms), and the speed it can correct is limited to minSpeed..maxSpeed.
+*/
+class KeyLock
+{
+public:
+    KeyLock();
+    ~KeyLock();
+
+    //Allocates, so it is never called while the audio callback is running
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+    //Forget everything played so far (audio thread)
+    void reset();
+
+    //Correct the pitch of numSamples played at speed, in place (audio thread)
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, double speed);
+
+    //Delay between the input and the corrected output
+    int getLatencyInSamples() const;
+
+    static constexpr double minSpeed = 0.5;
+    static constexpr double maxSpeed = 2.0;
+
+private:
+    //Overlap-add the grain that starts at output sample grainTime
+    void addGrain(juce::int64 grainTime, double ratio);
+    //Start (in input samples) near nominalStart that best continues the previous grain
+    juce::int64 findGrainStart(juce::int64 nominalStart) const;
+
+    //Input history (two channels and their mono sum for the search), a power of two long
+    juce::AudioBuffer<float> history;
+    int historyMask = 0;
+    juce::int64 numWritten = 0;
+
+    //Overlap-add accumulator, a power of two long
+    juce::AudioBuffer<float> output;
+    int outputMask = 0;
+    juce::int64 numRead = 0;
+    int maxBlockSize = 512;
+
+    //Grains
+    std::vector<float> window;
+    int grainLength = 0;
+    int hop = 0;
+    int searchRange = 0;
+    int searchStride = 1;
+    int latency = 0;
+    juce::int64 nextGrainTime = 0;
+    double lastGrainStart = 0;
+    double lastRatio = 1.0;
+    bool hasLastGrain = false;
+
+    //Points of the decimated similarity search, whatever the sample rate
+    static constexpr int searchPoints = 128;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KeyLock)
+};
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    ReadAheadSource.cpp
+    Created: 6 Sep 2022 11:03:45am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "ReadAheadSource.h"
+
+ReadAheadSource::ReadAheadSource(juce::PositionableAudioSource* sourceToBuffer,
+                                 juce::TimeSliceThread& readAheadThread,
+                                 int numSamplesToBuffer,
+                                 std::atomic<int>& _underrunCounter) : source(sourceToBuffer),
+                                                                       buffered(sourceToBuffer, readAheadThread, false, numSamplesToBuffer, 2),
+                                                                       underrunCounter(_underrunCounter)
+{
+}
+
+ReadAheadSource::~ReadAheadSource()
+{
+}
+
+//==============================================================================
+void ReadAheadSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    //Prefills the buffer, so this is called off the audio thread (loader thread)
+    buffered.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void ReadAheadSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    //Zero timeout: only check if the disk thread is ahead of us, never wait for it
+    if (!buffered.waitForNextAudioBlockReady(bufferToFill, 0))
+    {
+        ++underrunCounter;
+        AudioProfiler::mark("Read-ahead underrun");
+    }
+
+    buffered.getNextAudioBlock(bufferToFill);
+}
+
+void ReadAheadSource::releaseResources()
+{
+    buffered.releaseResources();
+}
+
+//==============================================================================
+void ReadAheadSource::setNextReadPosition(juce::int64 newPosition)
+{
+    buffered.setNextReadPosition(newPosition);
+}
+
+juce::int64 ReadAheadSource::getNextReadPosition() const
+{
+    return buffered.getNextReadPosition();
+}
+
+juce::int64 ReadAheadSource::getTotalLength() const
+{
+    return buffered.getTotalLength();
+}
+
+bool ReadAheadSource::isLooping() const
+{
+    return buffered.isLooping();
+}
+
+void ReadAheadSource::setLooping(bool shouldLoop)
+{
+    source->setLooping(shouldLoop);
+}
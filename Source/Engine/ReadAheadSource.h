@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    ReadAheadSource.h
+    Created: 6 Sep 2022 11:03:45am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioProfiler.h"
+
+//==============================================================================
+/*
+    Reads a track ahead on a shared TimeSliceThread so the audio callback only
+    ever copies from memory. Every block that asks for samples the disk thread
+    has not buffered yet is counted as an underrun.
+*/
+class ReadAheadSource : public juce::PositionableAudioSource
+{
+public:
+    ReadAheadSource(juce::PositionableAudioSource* sourceToBuffer,
+                    juce::TimeSliceThread& readAheadThread,
+                    int numSamplesToBuffer,
+                    std::atomic<int>& _underrunCounter);
+    ~ReadAheadSource() override;
+
+    //Virtual pure functions from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //Virtual pure functions from PositionableAudioSource
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+private:
+    //The track source (owned) and the buffer in front of it
+    std::unique_ptr<juce::PositionableAudioSource> source;
+    juce::BufferingAudioSource buffered;
+
+    //Underrun counter of the deck that owns this source
+    std::atomic<int>& underrunCounter;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReadAheadSource)
+};
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    ResamplingKernel.cpp
+    Created: 28 Sep 2022 9:52:16am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "ResamplingKernel.h"
+
+//Finer near 1, where the pitch bend and the common file / device rate pairs sit
+const double ResamplingKernel::bandSteps[ResamplingKernel::numBands] = { 1.0, 1.06, 1.12, 1.25, 1.5, 2.0, 2.5, 3.0, 4.0, 8.0 };
+
+namespace
+{
+    //Zeroth-order modified Bessel function of the first kind (for the Kaiser window)
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1.0e-12)
+            {
+                break;
+            }
+        }
+        return sum;
+    }
+}
+
+//==============================================================================
+const ResamplingKernel& ResamplingKernel::get(Quality quality)
+{
+    static const ResamplingKernel kernels[] = { ResamplingKernel(lowQuality),
+                                                ResamplingKernel(mediumQuality),
+                                                ResamplingKernel(highQuality) };
+    return kernels[juce::jlimit(0, 2, (int) quality)];
+}
+
+ResamplingKernel::ResamplingKernel(Quality quality)
+{
+    if (quality == lowQuality)
+    {
+        return;
+    }
+
+    numTaps = quality == highQuality ? 32 : 16;
+    //Stopband of about 60 dB for medium and 90 dB for high
+    double beta = quality == highQuality ? 8.6 : 5.7;
+    double halfWidth = numTaps / 2;
+    double windowScale = 1.0 / besselI0(beta);
+
+    size_t rows = (size_t) numBands * (size_t) (numPhases + 1);
+    table.assign(rows * (size_t) numTaps, 0.0f);
+    slopeTable.assign(rows * (size_t) numTaps, 0.0f);
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        //Cutoff below the output Nyquist for the largest step of the band, with room for the transition
+        double cutoff = 0.92 / bandSteps[band];
+
+        for (int phase = 0; phase <= numPhases; ++phase)
+        {
+            float* row = table.data() + ((size_t) band * (size_t) (numPhases + 1) + (size_t) phase) * (size_t) numTaps;
+            double t = (double) phase / numPhases;
+            double sum = 0.0;
+
+            for (int k = 0; k < numTaps; ++k)
+            {
+                //Distance of the tap from the interpolated position
+                double d = (double) (k - (numTaps / 2 - 1)) - t;
+                double x = cutoff * d;
+                double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                double r = juce::jlimit(0.0, 1.0, d / halfWidth * d / halfWidth);
+                double value = sinc * besselI0(beta * std::sqrt(1.0 - r)) * windowScale;
+
+                row[k] = (float) value;
+                sum += value;
+            }
+
+            //Unity gain at DC for every phase, so there is no ripple from phase to phase
+            for (int k = 0; k < numTaps; ++k)
+            {
+                row[k] = (float) (row[k] / sum);
+            }
+        }
+
+        for (int phase = 0; phase < numPhases; ++phase)
+        {
+            size_t row = ((size_t) band * (size_t) (numPhases + 1) + (size_t) phase) * (size_t) numTaps;
+            for (int k = 0; k < numTaps; ++k)
+            {
+                slopeTable[row + (size_t) k] = table[row + (size_t) numTaps + (size_t) k] - table[row + (size_t) k];
+            }
+        }
+    }
+}
+
+//==============================================================================
+int ResamplingKernel::getBand(double step) const
+{
+    for (int band = 0; band < numBands; ++band)
+    {
+        if (step <= bandSteps[band])
+        {
+            return band;
+        }
+    }
+    return numBands - 1;
+}
+
+int ResamplingKernel::getTapsBefore() const
+{
+    return numTaps / 2 - 1;
+}
+
+int ResamplingKernel::getTapsAfter() const
+{
+    return numTaps / 2;
+}
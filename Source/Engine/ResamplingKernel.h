@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    ResamplingKernel.h
+    Created: 28 Sep 2022 9:52:16am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    The interpolation the transport reads tracks with, in one step from the
+    file rate at the deck speed to the device rate.
+
+    Low is the 4-point Hermite the transport has always used. Medium and high
+    are polyphase windowed-sinc filters (16 and 32 taps, Kaiser window) with
+    256 phases, linearly interpolated between neighbouring phases. When the
+    track is read faster than the device rate (speed up, or a file rate above
+    the device rate) the cutoff drops with the step so nothing folds back:
+    there is a table for each band of steps up to 8 (the cost does not change).
+
+    Both channels are filtered in the same pass over the taps, with four
+    independent accumulators per channel so the compiler maps them onto SIMD
+    lanes (SSE/NEON) without needing fast-math.
+
+    Tables are built once, by the first get() (call it off the audio thread).
+*/
+class ResamplingKernel
+{
+public:
+    enum Quality
+    {
+        lowQuality = 0,
+        mediumQuality,
+        highQuality
+    };
+
+    //The kernel of a quality (the first call builds every table)
+    static const ResamplingKernel& get(Quality quality);
+
+    //Band of the anti-aliasing table for reading step track samples per output sample (once per chunk)
+    int getBand(double step) const;
+
+    //Interpolate both channels at t (0..1) after x, where left and right point at x in each channel.
+    //Reads getTapsBefore() samples before x and getTapsAfter() after it
+    inline void interpolate(const float* left, const float* right, float t, int band, float& outLeft, float& outRight) const
+    {
+        if (numTaps == 4)
+        {
+            outLeft = hermite(left, t);
+            outRight = hermite(right, t);
+            return;
+        }
+
+        float position = t * numPhases;
+        int phase = juce::jmin((int) position, numPhases - 1);
+        float fraction = position - (float) phase;
+
+        size_t row = ((size_t) band * (size_t) (numPhases + 1) + (size_t) phase) * (size_t) numTaps;
+        const float* coefficients = table.data() + row;
+        const float* slopes = slopeTable.data() + row;
+        left -= numTaps / 2 - 1;
+        right -= numTaps / 2 - 1;
+
+        //Four lanes per channel, taps are a multiple of 4
+        float sumLeft[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float sumRight[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int k = 0; k < numTaps; k += 4)
+        {
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                float c = coefficients[k + lane] + fraction * slopes[k + lane];
+                sumLeft[lane] += c * left[k + lane];
+                sumRight[lane] += c * right[k + lane];
+            }
+        }
+
+        outLeft = (sumLeft[0] + sumLeft[2]) + (sumLeft[1] + sumLeft[3]);
+        outRight = (sumRight[0] + sumRight[2]) + (sumRight[1] + sumRight[3]);
+    }
+
+    int getTapsBefore() const;
+    int getTapsAfter() const;
+
+    //Most samples any kernel reads before or after the interpolated position
+    static constexpr int maxTaps = 32;
+
+private:
+    explicit ResamplingKernel(Quality quality);
+
+    //4-point Hermite interpolation between x[0] and x[1] (reads x[-1] to x[2])
+    static inline float hermite(const float* x, float t)
+    {
+        float c1 = 0.5f * (x[1] - x[-1]);
+        float c2 = x[-1] - 2.5f * x[0] + 2.0f * x[1] - 0.5f * x[2];
+        float c3 = 0.5f * (x[2] - x[-1]) + 1.5f * (x[0] - x[1]);
+        return ((c3 * t + c2) * t + c1) * t + x[0];
+    }
+
+    int numTaps = 4;
+    //Coefficients per band, phase (numPhases + 1 rows) and tap, and the change to the next phase
+    std::vector<float> table;
+    std::vector<float> slopeTable;
+
+    static constexpr int numPhases = 256;
+    static constexpr int numBands = 10;
+    //Largest step of each band (the cutoff of a band is set for its largest step)
+    static const double bandSteps[numBands];
+
+    JUCE_DECLARE_NON_COPYABLE (ResamplingKernel)
+};
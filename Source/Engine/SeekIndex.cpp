@@ -0,0 +1,388 @@
+/*
+  ==============================================================================
+
+    SeekIndex.cpp
+    Created: 1 Oct 2022 11:18:40am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "SeekIndex.h"
+
+namespace
+{
+    //A parsed MPEG audio frame header
+    struct FrameHeader
+    {
+        int version = 0;   //0 is MPEG 1, 1 is MPEG 2, 2 is MPEG 2.5
+        int layer = 0;
+        int sampleRate = 0;
+        int frameSize = 0;
+        int samplesPerFrame = 0;
+    };
+
+    //Parse the 4 header bytes at data, returns false if they are not a valid frame header
+    bool parseFrameHeader(const juce::uint8* data, FrameHeader& header)
+    {
+        //Sync word (11 bits)
+        if (data[0] != 0xff || (data[1] & 0xe0) != 0xe0)
+        {
+            return false;
+        }
+
+        int versionBits = (data[1] >> 3) & 3;
+        int layerBits = (data[1] >> 1) & 3;
+        int bitrateIndex = (data[2] >> 4) & 15;
+        int sampleRateIndex = (data[2] >> 2) & 3;
+        int padding = (data[2] >> 1) & 1;
+
+        //Reserved values, free format and bad bit rates are not indexed
+        if (versionBits == 1 || layerBits == 0 || bitrateIndex == 0 || bitrateIndex == 15 || sampleRateIndex == 3)
+        {
+            return false;
+        }
+
+        static const int bitrates[5][16] = {
+            { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 },   //MPEG 1 layer I
+            { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0 },      //MPEG 1 layer II
+            { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 },       //MPEG 1 layer III
+            { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0 },      //MPEG 2 and 2.5 layer I
+            { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 }            //MPEG 2 and 2.5 layers II and III
+        };
+        static const int sampleRates[3][3] = { { 44100, 48000, 32000 }, { 22050, 24000, 16000 }, { 11025, 12000, 8000 } };
+
+        header.version = versionBits == 3 ? 0 : versionBits == 2 ? 1 : 2;
+        header.layer = 4 - layerBits;
+        header.sampleRate = sampleRates[header.version][sampleRateIndex];
+
+        int table = header.version == 0 ? header.layer - 1 : (header.layer == 1 ? 3 : 4);
+        int bitrate = bitrates[table][bitrateIndex] * 1000;
+
+        if (header.layer == 1)
+        {
+            header.frameSize = (12 * bitrate / header.sampleRate + padding) * 4;
+            header.samplesPerFrame = 384;
+        }
+        else if (header.layer == 3 && header.version != 0)
+        {
+            header.frameSize = 72 * bitrate / header.sampleRate + padding;
+            header.samplesPerFrame = 576;
+        }
+        else
+        {
+            header.frameSize = 144 * bitrate / header.sampleRate + padding;
+            header.samplesPerFrame = 1152;
+        }
+        return header.frameSize > 4;
+    }
+
+    //Whether a frame is the Xing / Info / VBRI tag some encoders put first (it holds no audio)
+    bool isTagFrame(const juce::uint8* frame, int frameSize)
+    {
+        int numToSearch = juce::jmin(frameSize, 64) - 4;
+        for (int i = 4; i < numToSearch; ++i)
+        {
+            if (std::memcmp(frame + i, "Xing", 4) == 0 || std::memcmp(frame + i, "Info", 4) == 0 || std::memcmp(frame + i, "VBRI", 4) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //Saved table layout
+    const char* const indexMagic = "OSKX";
+    constexpr int indexVersion = 1;
+}
+
+//==============================================================================
+std::unique_ptr<SeekIndex> SeekIndex::build(const juce::File& track)
+{
+    if (!canIndex(track))
+    {
+        return nullptr;
+    }
+
+    juce::MemoryBlock data;
+    if (!track.loadFileAsData(data) || data.getSize() < 4)
+    {
+        return nullptr;
+    }
+
+    auto* bytes = static_cast<const juce::uint8*>(data.getData());
+    auto size = (juce::int64) data.getSize();
+    juce::int64 pos = 0;
+
+    //Skip an ID3v2 tag (its size is stored in 7-bit bytes)
+    if (size >= 10 && std::memcmp(bytes, "ID3", 3) == 0)
+    {
+        pos = 10 + (((juce::int64) (bytes[6] & 0x7f) << 21) | ((bytes[7] & 0x7f) << 14) | ((bytes[8] & 0x7f) << 7) | (bytes[9] & 0x7f));
+        if ((bytes[5] & 0x10) != 0)   //Footer
+        {
+            pos += 10;
+        }
+    }
+
+    std::unique_ptr<SeekIndex> index(new SeekIndex());
+    index->trackFile = track;
+    index->trackSize = track.getSize();
+    index->trackModified = track.getLastModificationTime().toMilliseconds();
+
+    FrameHeader first;
+    bool firstFrame = true;
+    juce::int64 numFrames = 0;
+    while (pos + 4 <= size)
+    {
+        FrameHeader header;
+        if (!parseFrameHeader(bytes + pos, header))
+        {
+            ++pos;
+            continue;
+        }
+
+        //A real frame is followed by another frame of the same stream (or the end of the file)
+        juce::int64 nextPos = pos + header.frameSize;
+        FrameHeader nextHeader;
+        bool followed = nextPos + 4 > size
+                        || (parseFrameHeader(bytes + nextPos, nextHeader)
+                            && nextHeader.version == header.version
+                            && nextHeader.layer == header.layer
+                            && nextHeader.sampleRate == header.sampleRate);
+        bool sameStream = numFrames == 0 || (header.version == first.version && header.layer == first.layer && header.sampleRate == first.sampleRate);
+        if (!followed || !sameStream || nextPos > size)
+        {
+            ++pos;
+            continue;
+        }
+
+        if (firstFrame)
+        {
+            first = header;
+            firstFrame = false;
+            //The tag frame is not part of the decoded track
+            if (isTagFrame(bytes + pos, header.frameSize))
+            {
+                pos = nextPos;
+                continue;
+            }
+        }
+
+        if (numFrames % framesPerPoint == 0)
+        {
+            index->pointOffsets.push_back(pos);
+        }
+        ++numFrames;
+        pos = nextPos;
+    }
+
+    if (numFrames == 0)
+    {
+        return nullptr;
+    }
+
+    index->sampleRate = first.sampleRate;
+    index->samplesPerFrame = first.samplesPerFrame;
+    index->totalLength = numFrames * first.samplesPerFrame;
+    return index;
+}
+
+std::unique_ptr<SeekIndex> SeekIndex::findFor(const juce::File& track)
+{
+    if (!canIndex(track))
+    {
+        return nullptr;
+    }
+
+    juce::FileInputStream in(getIndexFileFor(track));
+    if (!in.openedOk())
+    {
+        return nullptr;
+    }
+
+    char magic[4] = {};
+    in.read(magic, 4);
+    if (std::memcmp(magic, indexMagic, 4) != 0 || in.readInt() != indexVersion)
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<SeekIndex> index(new SeekIndex());
+    index->trackFile = track;
+    index->trackSize = in.readInt64();
+    index->trackModified = in.readInt64();
+
+    //The track has been changed since it was indexed
+    if (index->trackSize != track.getSize() || index->trackModified != track.getLastModificationTime().toMilliseconds())
+    {
+        return nullptr;
+    }
+
+    index->sampleRate = in.readDouble();
+    index->samplesPerFrame = in.readInt();
+    index->totalLength = in.readInt64();
+    int numPoints = in.readInt();
+    if (numPoints <= 0 || index->samplesPerFrame <= 0 || in.getNumBytesRemaining() < (juce::int64) numPoints * 8)
+    {
+        return nullptr;
+    }
+
+    index->pointOffsets.resize((size_t) numPoints);
+    for (auto& offset : index->pointOffsets)
+    {
+        offset = in.readInt64();
+    }
+    return index;
+}
+
+bool SeekIndex::save() const
+{
+    auto indexFile = getIndexFileFor(trackFile);
+    if (!indexFile.getParentDirectory().createDirectory())
+    {
+        std::cout << "SeekIndex::save cannot create " << indexFile.getParentDirectory().getFullPathName() << std::endl;
+        return false;
+    }
+
+    //Written next to it and moved over, a half written table is never read
+    juce::TemporaryFile temp(indexFile);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+        {
+            return false;
+        }
+
+        out.write(indexMagic, 4);
+        out.writeInt(indexVersion);
+        out.writeInt64(trackSize);
+        out.writeInt64(trackModified);
+        out.writeDouble(sampleRate);
+        out.writeInt(samplesPerFrame);
+        out.writeInt64(totalLength);
+        out.writeInt((int) pointOffsets.size());
+        for (auto offset : pointOffsets)
+        {
+            out.writeInt64(offset);
+        }
+        out.flush();
+        if (out.getStatus().failed())
+        {
+            return false;
+        }
+    }
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+bool SeekIndex::canIndex(const juce::File& track)
+{
+    return track.hasFileExtension(".mp3;.mp2;.mpga");
+}
+
+juce::File SeekIndex::getIndexFileFor(const juce::File& track)
+{
+    auto folder = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory).getChildFile("Otodesks").getChildFile("SeekIndex");
+    return folder.getChildFile(juce::String::toHexString(track.getFullPathName().hashCode64()) + ".seek");
+}
+
+//==============================================================================
+int SeekIndex::findPoint(juce::int64 trackSample) const
+{
+    auto point = trackSample / getSamplesPerPoint();
+    return (int) juce::jlimit((juce::int64) 0, (juce::int64) pointOffsets.size() - 1, point);
+}
+
+juce::int64 SeekIndex::getPointOffset(int point) const
+{
+    return pointOffsets[(size_t) point];
+}
+
+juce::int64 SeekIndex::getPointSample(int point) const
+{
+    return (juce::int64) point * getSamplesPerPoint();
+}
+
+int SeekIndex::getNumPoints() const
+{
+    return (int) pointOffsets.size();
+}
+
+int SeekIndex::getSamplesPerPoint() const
+{
+    return samplesPerFrame * framesPerPoint;
+}
+
+juce::int64 SeekIndex::getTotalLength() const
+{
+    return totalLength;
+}
+
+double SeekIndex::getSampleRate() const
+{
+    return sampleRate;
+}
+
+//==============================================================================
+class SeekIndexBuilder::BuildJob : public juce::ThreadPoolJob
+{
+public:
+    BuildJob(SeekIndexBuilder& _owner, const juce::File& _track) : juce::ThreadPoolJob("Index " + _track.getFileName()),
+                                                                   owner(_owner),
+                                                                   track(_track)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        AudioProfiler::nameThread("Seek indexer");
+
+        {
+            OTODESKS_PROFILE_SCOPE("SeekIndexBuilder::build");
+            //Indexed already (by an earlier import of the same file)
+            auto index = SeekIndex::findFor(track) == nullptr ? SeekIndex::build(track) : nullptr;
+            if (index != nullptr)
+            {
+                index->save();
+            }
+        }
+
+        const juce::ScopedLock sl(owner.lock);
+        owner.building.erase(track.getFullPathName().toStdString());
+        return jobHasFinished;
+    }
+
+private:
+    SeekIndexBuilder& owner;
+    juce::File track;
+};
+
+//==============================================================================
+SeekIndexBuilder::SeekIndexBuilder()
+{
+}
+
+SeekIndexBuilder::~SeekIndexBuilder()
+{
+    //Stop the builds that are still running before the builder goes away
+    buildPool.removeAllJobs(true, 4000);
+}
+
+void SeekIndexBuilder::request(const juce::File& track)
+{
+    if (!SeekIndex::canIndex(track))   //Not a compressed track
+    {
+        return;
+    }
+
+    auto key = track.getFullPathName().toStdString();
+    {
+        const juce::ScopedLock sl(lock);
+        if (building.count(key) != 0)   //On its way
+        {
+            return;
+        }
+        building.insert(key);
+    }
+
+    buildPool.addJob(new BuildJob(*this, track), true);
+}
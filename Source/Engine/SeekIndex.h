@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    SeekIndex.h
+    Created: 1 Oct 2022 11:18:40am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <string>
+#include <unordered_set>
+#include "AudioProfiler.h"
+
+//==============================================================================
+/*
+    Seek table of a compressed track: the byte offset in the file of every
+    framesPerPoint-th audio frame, and so the track sample it starts at.
+
+    The MP3 reader seeks by decoding its way forward from the last frame it
+    has seen, so a jump far into a track it has not played yet decodes
+    everything in between. With the table a decoder can be started a point
+    before any position instead (see SeekIndexedSource), whatever the
+    position. It is built by scanning the frame headers (nothing is decoded).
+
+    Tables are saved in the library folder of the app data, keyed by the path,
+    size and modification time of the track, so a track that changes is
+    indexed again.
+*/
+class SeekIndex
+{
+public:
+    //Scan the frames of an MPEG audio file, returns nullptr for any other file (or a damaged one)
+    static std::unique_ptr<SeekIndex> build(const juce::File& track);
+
+    //The saved table of a track, nullptr when there is none or the track has changed since
+    static std::unique_ptr<SeekIndex> findFor(const juce::File& track);
+    //Save the table where findFor looks for it
+    bool save() const;
+
+    //Whether a track is a format the table is built for (by its extension)
+    static bool canIndex(const juce::File& track);
+    //Where the table of a track is saved
+    static juce::File getIndexFileFor(const juce::File& track);
+
+    //The point at or before a track sample, and where it is
+    int findPoint(juce::int64 trackSample) const;
+    juce::int64 getPointOffset(int point) const;
+    juce::int64 getPointSample(int point) const;
+    int getNumPoints() const;
+    //Track samples between two points
+    int getSamplesPerPoint() const;
+
+    //Exact length of the track in samples (every audio frame counted)
+    juce::int64 getTotalLength() const;
+    double getSampleRate() const;
+
+    //Frames per point (MP3 frames hold 1152 or 576 samples, so a point is about 0.1 s)
+    static constexpr int framesPerPoint = 4;
+
+private:
+    SeekIndex() = default;
+
+    juce::File trackFile;
+    juce::int64 trackSize = 0;
+    juce::int64 trackModified = 0;
+    double sampleRate = 0;
+    int samplesPerFrame = 0;
+    juce::int64 totalLength = 0;
+    std::vector<juce::int64> pointOffsets;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SeekIndex)
+};
+
+//==============================================================================
+/*
+    Builds and saves the seek tables of tracks on a background thread, as they
+    are imported, so they are there before the track is first played.
+*/
+class SeekIndexBuilder
+{
+public:
+    SeekIndexBuilder();
+    ~SeekIndexBuilder();
+
+    //Build the table of a track in the background unless it is saved already (any thread)
+    void request(const juce::File& track);
+
+private:
+    class BuildJob;
+
+    juce::CriticalSection lock;
+    std::unordered_set<std::string> building;
+
+    juce::ThreadPool buildPool{ 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SeekIndexBuilder)
+};
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    SeekIndexedSource.cpp
+    Created: 1 Oct 2022 2:37:05pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "SeekIndexedSource.h"
+
+SeekIndexedSource::SeekIndexedSource(juce::AudioFormat& _format,
+                                     const juce::File& _track,
+                                     std::unique_ptr<SeekIndex> _index,
+                                     std::unique_ptr<juce::AudioFormatReader> wholeTrackReader) : format(_format),
+                                                                                                  track(_track),
+                                                                                                  index(std::move(_index)),
+                                                                                                  reader(std::move(wholeTrackReader))
+{
+}
+
+SeekIndexedSource::~SeekIndexedSource()
+{
+}
+
+//==============================================================================
+void SeekIndexedSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+}
+
+void SeekIndexedSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto length = getTotalLength();
+
+    int done = 0;
+    while (done < bufferToFill.numSamples)
+    {
+        if (looping && length > 0)
+        {
+            position %= length;
+        }
+
+        //Past the end (not looping) or no decoder, the rest of the block is silent
+        if (position < 0 || position >= length || reader == nullptr)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + done, bufferToFill.numSamples - done);
+            position += bufferToFill.numSamples - done;
+            break;
+        }
+
+        //A jump back, or far ahead, starts a decoder from the seek table
+        if (position < readerPosition || position - readerPosition > 2 * index->getSamplesPerPoint())
+        {
+            if (!openDecoderBefore(position))
+            {
+                continue;
+            }
+        }
+
+        int numToRead = (int) juce::jmin((juce::int64) (bufferToFill.numSamples - done), length - position);
+        reader->read(bufferToFill.buffer, bufferToFill.startSample + done, numToRead, position - readerStart, true, true);
+
+        done += numToRead;
+        position += numToRead;
+        readerPosition = position;
+    }
+}
+
+void SeekIndexedSource::releaseResources()
+{
+}
+
+bool SeekIndexedSource::openDecoderBefore(juce::int64 trackSample)
+{
+    OTODESKS_PROFILE_SCOPE("SeekIndexedSource::openDecoder");
+
+    //A point of run-up, the first frames of a new decoder are not complete
+    int point = juce::jmax(0, index->findPoint(trackSample) - 1);
+
+    std::unique_ptr<juce::AudioFormatReader> newReader;
+    if (auto stream = track.createInputStream())
+    {
+        auto* frames = new juce::SubregionStream(stream.release(), index->getPointOffset(point), -1, true);
+        newReader.reset(format.createReaderFor(frames, true));
+    }
+
+    if (newReader == nullptr)
+    {
+        std::cout << "SeekIndexedSource::openDecoderBefore cannot open " << track.getFileName() << " at point " << point << std::endl;
+        reader.reset();
+        return false;
+    }
+
+    reader = std::move(newReader);
+    readerStart = index->getPointSample(point);
+    readerPosition = readerStart;
+    return true;
+}
+
+//==============================================================================
+void SeekIndexedSource::setNextReadPosition(juce::int64 newPosition)
+{
+    //The decoder is moved (if it has to be) by the next read
+    position = newPosition;
+}
+
+juce::int64 SeekIndexedSource::getNextReadPosition() const
+{
+    auto length = getTotalLength();
+    return looping && length > 0 ? position % length : position;
+}
+
+juce::int64 SeekIndexedSource::getTotalLength() const
+{
+    return index->getTotalLength();
+}
+
+bool SeekIndexedSource::isLooping() const
+{
+    return looping;
+}
+
+void SeekIndexedSource::setLooping(bool shouldLoop)
+{
+    looping = shouldLoop;
+}
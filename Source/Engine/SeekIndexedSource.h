@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    SeekIndexedSource.h
+    Created: 1 Oct 2022 2:37:05pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SeekIndex.h"
+
+//==============================================================================
+/*
+    Plays a compressed track with a seek table: a jump starts a new decoder on
+    the frame a point before the new position (so the bit reservoir and the
+    overlap of the first frames are filled again) and decodes forward from
+    there, at most two points (about 0.2 s of audio) whatever the position.
+    Reading on in order, or skipping a little forward, keeps the decoder that
+    is running.
+*/
+class SeekIndexedSource : public juce::PositionableAudioSource
+{
+public:
+    SeekIndexedSource(juce::AudioFormat& _format,
+                      const juce::File& _track,
+                      std::unique_ptr<SeekIndex> _index,
+                      std::unique_ptr<juce::AudioFormatReader> wholeTrackReader);
+    ~SeekIndexedSource() override;
+
+    //Virtual pure functions from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //Virtual pure functions from PositionableAudioSource
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+private:
+    //Start a decoder at the point a point before trackSample, returns false if the frame could not be opened
+    bool openDecoderBefore(juce::int64 trackSample);
+
+    juce::AudioFormat& format;
+    juce::File track;
+    std::unique_ptr<SeekIndex> index;
+
+    //The running decoder, and the track sample its first output sample is
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::int64 readerStart = 0;
+    //Track sample the decoder would produce next
+    juce::int64 readerPosition = 0;
+
+    juce::int64 position = 0;
+    std::atomic<bool> looping{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SeekIndexedSource)
+};
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    TrackLoader.cpp
+    Created: 4 Sep 2022 2:16:08pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "TrackLoader.h"
+
+TrackLoader::TrackLoader(juce::AudioFormatManager& _formatManager,
+                         DecodedTrackCache& _trackCache,
+                         Callback _onLoaded) : juce::Thread("Track loader"),
+                                               formatManager(_formatManager),
+                                               trackCache(_trackCache),
+                                               onLoaded(std::move(_onLoaded))
+{
+    startThread();
+}
+
+TrackLoader::~TrackLoader()
+{
+    cancelPendingLoads();
+    signalThreadShouldExit();
+    notify();
+    stopThread(4000);
+}
+
+int TrackLoader::requestLoad(const juce::URL& audioURL, bool looping)
+{
+    int loadId;
+    {
+        const juce::ScopedLock sl(requestLock);
+        //A new request makes the previous one stale
+        loadId = ++latestLoadId;
+        pendingURL = audioURL;
+        pendingLooping = looping;
+        hasPendingRequest = true;
+        loading = true;
+    }
+
+    //Wake the loader thread up
+    notify();
+    return loadId;
+}
+
+void TrackLoader::cancelPendingLoads()
+{
+    const juce::ScopedLock sl(requestLock);
+    //Bumping the id makes whatever is in flight stale
+    ++latestLoadId;
+    hasPendingRequest = false;
+    loading = false;
+}
+
+bool TrackLoader::isLoading() const
+{
+    return loading;
+}
+
+bool TrackLoader::isCurrentLoad(int loadId) const
+{
+    return loadId == latestLoadId;
+}
+
+void TrackLoader::run()
+{
+    AudioProfiler::nameThread("Track loader");
+
+    while (!threadShouldExit())
+    {
+        Result result;
+        {
+            const juce::ScopedLock sl(requestLock);
+            if (hasPendingRequest)
+            {
+                result.url = pendingURL;
+                result.looping = pendingLooping;
+                result.loadId = latestLoadId;
+                hasPendingRequest = false;
+            }
+        }
+
+        if (result.loadId == 0)   //Nothing to do, sleep until the next request
+        {
+            wait(-1);
+            continue;
+        }
+
+        OTODESKS_PROFILE_SCOPE("TrackLoader::load");
+
+        if (auto track = trackCache.find(result.url))   //Already decoded, no disk access at all
+        {
+            result.sampleRate = track->sampleRate;
+            result.source.reset(new CachedTrackSource(track));
+            result.source->setLooping(result.looping);
+            result.fromCache = true;
+        }
+        else
+        {
+            //Open the file (this is the slow part that used to run on the message thread)
+            std::unique_ptr<juce::AudioFormatReader> reader;
+            if (auto stream = result.url.createInputStream(false))
+            {
+                reader.reset(formatManager.createReaderFor(std::move(stream)));
+            }
+
+            //Drop the result if a newer request came in while the file was opening
+            if (!isCurrentLoad(result.loadId))
+            {
+                continue;
+            }
+
+            if (reader != nullptr)   //Good file
+            {
+                result.sampleRate = reader->sampleRate;
+
+                //A compressed track with a seek table jumps anywhere by decoding from the nearest frame
+                auto* format = result.url.isLocalFile() ? formatManager.findFormatForFileExtension(result.url.getLocalFile().getFileExtension()) : nullptr;
+                auto index = format != nullptr ? SeekIndex::findFor(result.url.getLocalFile()) : nullptr;
+                if (index != nullptr)
+                {
+                    result.source.reset(new SeekIndexedSource(*format, result.url.getLocalFile(), std::move(index), std::move(reader)));
+                }
+                else
+                {
+                    result.source.reset(new juce::AudioFormatReaderSource(reader.release(), true));
+                }
+                result.source->setLooping(result.looping);
+            }
+        }
+
+        {
+            OTODESKS_PROFILE_SCOPE("TrackLoader::onLoaded");
+            onLoaded(result);
+        }
+
+        {
+            const juce::ScopedLock sl(requestLock);
+            if (!hasPendingRequest && isCurrentLoad(result.loadId))
+            {
+                loading = false;
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    TrackLoader.h
+    Created: 4 Sep 2022 2:16:08pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include "CachedTrackSource.h"
+#include "SeekIndexedSource.h"
+
+//==============================================================================
+/*
+    Opens tracks on its own background thread so the message thread never waits
+    on the disk or on the decoder. Only the newest request matters: a new request
+    (or cancelPendingLoads) makes any load that is still in flight stale, and a
+    stale result is thrown away instead of being handed to the player.
+    Tracks that are already in the decoded track cache are served from memory,
+    compressed ones with a saved seek table (see SeekIndex) seek through it.
+*/
+class TrackLoader : private juce::Thread
+{
+public:
+    //Data of a track that has been opened on the loader thread
+    struct Result
+    {
+        juce::URL url;
+        std::unique_ptr<juce::PositionableAudioSource> source;
+        double sampleRate = 0;
+        bool fromCache = false;
+        bool looping = false;
+        int loadId = 0;
+    };
+
+    //Called on the loader thread once a track is opened (source is nullptr if the file could not be opened)
+    using Callback = std::function<void(Result&)>;
+
+    TrackLoader(juce::AudioFormatManager& _formatManager, DecodedTrackCache& _trackCache, Callback _onLoaded);
+    ~TrackLoader() override;
+
+    //Queue a track to be opened, cancelling any load that is still pending, and return its load id
+    int requestLoad(const juce::URL& audioURL, bool looping);
+    //Cancel the pending load (if any), its result will never reach the callback
+    void cancelPendingLoads();
+
+    //Bool function to check if a load is queued or in flight
+    bool isLoading() const;
+    //Check if a load id is still the newest request
+    bool isCurrentLoad(int loadId) const;
+
+private:
+    void run() override;
+
+    juce::AudioFormatManager& formatManager;
+    DecodedTrackCache& trackCache;
+    Callback onLoaded;
+
+    //Newest request, guarded by requestLock
+    juce::CriticalSection requestLock;
+    juce::URL pendingURL;
+    bool pendingLooping = false;
+    bool hasPendingRequest = false;
+
+    std::atomic<int> latestLoadId{ 0 };
+    std::atomic<bool> loading{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackLoader)
+};
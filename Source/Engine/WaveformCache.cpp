@@ -0,0 +1,422 @@
+/*
+  ==============================================================================
+
+    WaveformCache.cpp
+    Created: 2 Oct 2022 10:41:27am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "WaveformCache.h"
+
+namespace
+{
+    //Merges bins of the same size, peaks by their extremes and RMS levels by their mean square
+    struct BinMerger
+    {
+        void add(const TrackWaveform::Bin& bin)
+        {
+            merged.min = numBins == 0 ? bin.min : juce::jmin(merged.min, bin.min);
+            merged.max = numBins == 0 ? bin.max : juce::jmax(merged.max, bin.max);
+            squares[0] += (float) bin.rms * bin.rms;
+            squares[1] += (float) bin.low * bin.low;
+            squares[2] += (float) bin.mid * bin.mid;
+            squares[3] += (float) bin.high * bin.high;
+            ++numBins;
+        }
+
+        TrackWaveform::Bin get() const
+        {
+            auto level = [this](float sumSquares) { return (juce::uint8) juce::roundToInt(std::sqrt(sumSquares / (float) juce::jmax(1, numBins))); };
+
+            TrackWaveform::Bin bin = merged;
+            bin.rms = level(squares[0]);
+            bin.low = level(squares[1]);
+            bin.mid = level(squares[2]);
+            bin.high = level(squares[3]);
+            return bin;
+        }
+
+        TrackWaveform::Bin merged;
+        float squares[4] = {};
+        int numBins = 0;
+    };
+
+    //RMS of samples on the 0 to 255 scale of a bin
+    juce::uint8 quantizeLevel(const float* samples, int numSamples)
+    {
+        float sumSquares = 0.0f;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            sumSquares += samples[i] * samples[i];
+        }
+        return (juce::uint8) juce::jlimit(0, 255, juce::roundToInt(std::sqrt(sumSquares / (float) numSamples) * 255.0f));
+    }
+
+    //Saved waveform layout
+    const char* const waveformMagic = "OWAV";
+    constexpr int waveformVersion = 2;
+}
+
+//==============================================================================
+TrackWaveform::TrackWaveform(std::vector<Bin> baseLevel, juce::int64 _lengthInSamples, double _sampleRate) : lengthInSamples(_lengthInSamples),
+                                                                                                            sampleRate(_sampleRate)
+{
+    levels.push_back(std::move(baseLevel));
+
+    //Each level merges pairs of bins of the one below
+    while (levels.back().size() > 1)
+    {
+        const auto& below = levels.back();
+        std::vector<Bin> level((below.size() + 1) / 2);
+        for (size_t i = 0; i < level.size(); ++i)
+        {
+            BinMerger merger;
+            merger.add(below[2 * i]);
+            if (2 * i + 1 < below.size())
+            {
+                merger.add(below[2 * i + 1]);
+            }
+            level[i] = merger.get();
+        }
+        levels.push_back(std::move(level));
+    }
+}
+
+int TrackWaveform::getLevelFor(double samplesPerPixel) const
+{
+    int level = 0;
+    while (level + 1 < (int) levels.size() && (double) getBinSize(level + 1) <= samplesPerPixel)
+    {
+        ++level;
+    }
+    return level;
+}
+
+int TrackWaveform::getNumLevels() const
+{
+    return (int) levels.size();
+}
+
+const std::vector<TrackWaveform::Bin>& TrackWaveform::getLevel(int level) const
+{
+    return levels[(size_t) level];
+}
+
+juce::int64 TrackWaveform::getBinSize(int level) const
+{
+    return (juce::int64) baseBinSize << level;
+}
+
+TrackWaveform::Bin TrackWaveform::getRange(int level, juce::int64 start, juce::int64 end) const
+{
+    const auto& bins = levels[(size_t) level];
+    auto binSize = getBinSize(level);
+    auto numBins = (juce::int64) bins.size();
+
+    auto first = juce::jlimit((juce::int64) 0, numBins - 1, start / binSize);
+    auto last = juce::jlimit(first + 1, numBins, (end + binSize - 1) / binSize);
+
+    BinMerger merger;
+    for (auto i = first; i < last; ++i)
+    {
+        merger.add(bins[(size_t) i]);
+    }
+    return merger.get();
+}
+
+juce::int64 TrackWaveform::getLengthInSamples() const
+{
+    return lengthInSamples;
+}
+
+double TrackWaveform::getSampleRate() const
+{
+    return sampleRate;
+}
+
+//==============================================================================
+class WaveformCache::AnalysisJob : public juce::ThreadPoolJob
+{
+public:
+    AnalysisJob(WaveformCache& _owner, const juce::URL& _audioURL) : juce::ThreadPoolJob("Waveform " + _audioURL.getFileName()),
+                                                                     owner(_owner),
+                                                                     audioURL(_audioURL)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        AudioProfiler::nameThread("Waveform analysis");
+
+        auto key = getKey(audioURL);
+        TrackWaveform::Ptr waveform;
+        {
+            OTODESKS_PROFILE_SCOPE("WaveformCache::load");
+            waveform = owner.load(audioURL, *this);
+        }
+
+        {
+            const juce::ScopedLock sl(owner.lock);
+            owner.analysing.erase(key);
+            if (waveform == nullptr && !shouldExit())   //Bad file (a cancelled job is tried again next time)
+            {
+                owner.failed.insert(key);
+            }
+            if (waveform != nullptr && owner.lookup.count(key) == 0)
+            {
+                owner.entries.push_front({ key, waveform });
+                owner.lookup[key] = owner.entries.begin();
+
+                //Forget the least recently used ones
+                while ((int) owner.entries.size() > owner.maxTracks)
+                {
+                    owner.lookup.erase(owner.entries.back().key);
+                    owner.entries.pop_back();
+                }
+            }
+        }
+
+        if (waveform != nullptr || !shouldExit())
+        {
+            owner.sendChangeMessage();
+        }
+        return jobHasFinished;
+    }
+
+private:
+    WaveformCache& owner;
+    juce::URL audioURL;
+};
+
+//==============================================================================
+WaveformCache::WaveformCache(juce::AudioFormatManager& _formatManager, int _maxTracks) : formatManager(_formatManager),
+                                                                                        maxTracks(_maxTracks)
+{
+}
+
+WaveformCache::~WaveformCache()
+{
+    //Stop analyses that are still running before the cache goes away
+    analysisPool.removeAllJobs(true, 4000);
+}
+
+TrackWaveform::Ptr WaveformCache::get(const juce::URL& audioURL)
+{
+    if (audioURL.isEmpty())
+    {
+        return nullptr;
+    }
+
+    auto key = getKey(audioURL);
+    {
+        const juce::ScopedLock sl(lock);
+        auto it = lookup.find(key);
+        if (it != lookup.end())
+        {
+            //Move it to the front (most recently used)
+            entries.splice(entries.begin(), entries, it->second);
+            return it->second->waveform;
+        }
+
+        if (analysing.count(key) != 0 || failed.count(key) != 0)   //On its way, or never will be
+        {
+            return nullptr;
+        }
+        analysing.insert(key);
+    }
+
+    analysisPool.addJob(new AnalysisJob(*this, audioURL), true);
+    return nullptr;
+}
+
+bool WaveformCache::hasFailed(const juce::URL& audioURL)
+{
+    const juce::ScopedLock sl(lock);
+    return failed.count(getKey(audioURL)) != 0;
+}
+
+TrackWaveform::Ptr WaveformCache::load(const juce::URL& audioURL, juce::ThreadPoolJob& job)
+{
+    //Analysed before (even in an earlier session)
+    if (audioURL.isLocalFile())
+    {
+        if (auto waveform = readFromDisk(audioURL.getLocalFile()))
+        {
+            return waveform;
+        }
+    }
+
+    auto waveform = analyse(audioURL, job);
+    if (waveform != nullptr && audioURL.isLocalFile())
+    {
+        writeToDisk(audioURL.getLocalFile(), *waveform);
+    }
+    return waveform;
+}
+
+TrackWaveform::Ptr WaveformCache::analyse(const juce::URL& audioURL, juce::ThreadPoolJob& job)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    if (auto stream = audioURL.createInputStream(false))
+    {
+        reader.reset(formatManager.createReaderFor(std::move(stream)));
+    }
+
+    if (reader == nullptr || reader->lengthInSamples <= 0)   //Bad file
+    {
+        return nullptr;
+    }
+
+    int numChannels = (int) juce::jmin(2u, reader->numChannels);
+    auto numBins = (reader->lengthInSamples + TrackWaveform::baseBinSize - 1) / TrackWaveform::baseBinSize;
+    std::vector<TrackWaveform::Bin> bins((size_t) numBins);
+
+    //Filterbank splitting the mono sum into the three bands
+    juce::IIRFilter lowFilter, midFilter, highFilter;
+    lowFilter.setCoefficients(juce::IIRCoefficients::makeLowPass(reader->sampleRate, TrackWaveform::lowBandEdge));
+    midFilter.setCoefficients(juce::IIRCoefficients::makeBandPass(reader->sampleRate,
+                                                                  std::sqrt(TrackWaveform::lowBandEdge * TrackWaveform::highBandEdge),
+                                                                  0.5));
+    highFilter.setCoefficients(juce::IIRCoefficients::makeHighPass(reader->sampleRate, TrackWaveform::highBandEdge));
+
+    //Decode in chunks (a whole number of bins) so the job can be cancelled quickly
+    const int chunkSize = 512 * TrackWaveform::baseBinSize;
+    juce::AudioBuffer<float> chunk(numChannels, chunkSize);
+    juce::AudioBuffer<float> bands(3, chunkSize);
+    for (juce::int64 pos = 0; pos < reader->lengthInSamples; pos += chunkSize)
+    {
+        if (job.shouldExit())
+        {
+            return nullptr;
+        }
+
+        int numSamples = (int) juce::jmin((juce::int64) chunkSize, reader->lengthInSamples - pos);
+        reader->read(&chunk, 0, numSamples, pos, true, true);
+
+        //Mono sum through each filter
+        for (int band = 0; band < 3; ++band)
+        {
+            bands.copyFrom(band, 0, chunk, 0, 0, numSamples);
+            for (int ch = 1; ch < numChannels; ++ch)
+            {
+                bands.addFrom(band, 0, chunk, ch, 0, numSamples);
+            }
+            bands.applyGain(band, 0, numSamples, 1.0f / (float) numChannels);
+        }
+        lowFilter.processSamples(bands.getWritePointer(0), numSamples);
+        midFilter.processSamples(bands.getWritePointer(1), numSamples);
+        highFilter.processSamples(bands.getWritePointer(2), numSamples);
+
+        for (int start = 0; start < numSamples; start += TrackWaveform::baseBinSize)
+        {
+            int binLength = juce::jmin(TrackWaveform::baseBinSize, numSamples - start);
+            float low = 0.0f;
+            float high = 0.0f;
+            float sumSquares = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto range = juce::FloatVectorOperations::findMinAndMax(chunk.getReadPointer(ch, start), binLength);
+                low = juce::jmin(low, range.getStart());
+                high = juce::jmax(high, range.getEnd());
+
+                auto rms = chunk.getRMSLevel(ch, start, binLength);
+                sumSquares += rms * rms;
+            }
+
+            auto& bin = bins[(size_t) ((pos + start) / TrackWaveform::baseBinSize)];
+            bin.min = (juce::int8) juce::jlimit(-127, 127, juce::roundToInt(low * 127.0f));
+            bin.max = (juce::int8) juce::jlimit(-127, 127, juce::roundToInt(high * 127.0f));
+            bin.rms = (juce::uint8) juce::jlimit(0, 255, juce::roundToInt(std::sqrt(sumSquares / (float) numChannels) * 255.0f));
+            bin.low = quantizeLevel(bands.getReadPointer(0, start), binLength);
+            bin.mid = quantizeLevel(bands.getReadPointer(1, start), binLength);
+            bin.high = quantizeLevel(bands.getReadPointer(2, start), binLength);
+        }
+    }
+
+    return new TrackWaveform(std::move(bins), reader->lengthInSamples, reader->sampleRate);
+}
+
+//==============================================================================
+TrackWaveform::Ptr WaveformCache::readFromDisk(const juce::File& track)
+{
+    juce::FileInputStream in(getCacheFileFor(track));
+    if (!in.openedOk())
+    {
+        return nullptr;
+    }
+
+    char magic[4] = {};
+    in.read(magic, 4);
+    if (std::memcmp(magic, waveformMagic, 4) != 0 || in.readInt() != waveformVersion)
+    {
+        return nullptr;
+    }
+
+    //The track has been changed since it was analysed
+    auto trackSize = in.readInt64();
+    auto trackModified = in.readInt64();
+    if (trackSize != track.getSize() || trackModified != track.getLastModificationTime().toMilliseconds())
+    {
+        return nullptr;
+    }
+
+    double sampleRate = in.readDouble();
+    auto lengthInSamples = in.readInt64();
+    auto numBins = (lengthInSamples + TrackWaveform::baseBinSize - 1) / TrackWaveform::baseBinSize;
+    if (lengthInSamples <= 0 || in.getNumBytesRemaining() != numBins * (juce::int64) sizeof(TrackWaveform::Bin))
+    {
+        return nullptr;
+    }
+
+    std::vector<TrackWaveform::Bin> bins((size_t) numBins);
+    in.read(bins.data(), (int) (numBins * (juce::int64) sizeof(TrackWaveform::Bin)));
+    return new TrackWaveform(std::move(bins), lengthInSamples, sampleRate);
+}
+
+bool WaveformCache::writeToDisk(const juce::File& track, const TrackWaveform& waveform)
+{
+    auto cacheFile = getCacheFileFor(track);
+    if (!cacheFile.getParentDirectory().createDirectory())
+    {
+        std::cout << "WaveformCache::writeToDisk cannot create " << cacheFile.getParentDirectory().getFullPathName() << std::endl;
+        return false;
+    }
+
+    //Written next to it and moved over, a half written waveform is never read
+    juce::TemporaryFile temp(cacheFile);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+        {
+            return false;
+        }
+
+        const auto& bins = waveform.getLevel(0);
+        out.write(waveformMagic, 4);
+        out.writeInt(waveformVersion);
+        out.writeInt64(track.getSize());
+        out.writeInt64(track.getLastModificationTime().toMilliseconds());
+        out.writeDouble(waveform.getSampleRate());
+        out.writeInt64(waveform.getLengthInSamples());
+        out.write(bins.data(), bins.size() * sizeof(TrackWaveform::Bin));
+        out.flush();
+        if (out.getStatus().failed())
+        {
+            return false;
+        }
+    }
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+juce::File WaveformCache::getCacheFileFor(const juce::File& track)
+{
+    auto folder = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory).getChildFile("Otodesks").getChildFile("Waveforms");
+    return folder.getChildFile(juce::String::toHexString(track.getFullPathName().hashCode64()) + ".wave");
+}
+
+std::string WaveformCache::getKey(const juce::URL& audioURL)
+{
+    return audioURL.toString(false).toStdString();
+}
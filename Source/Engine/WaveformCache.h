@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    WaveformCache.h
+    Created: 2 Oct 2022 10:41:27am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include "AudioProfiler.h"
+
+//==============================================================================
+/*
+    The waveform of a whole track as a min / max / RMS pyramid. The base level
+    has a bin for every baseBinSize samples (both channels together), every
+    level above halves the number of bins, up to a single bin for the track.
+    Bins also hold the RMS of the low, mid and high bands, to colour the
+    waveform by what is playing (kick and bass, voices, hats).
+
+    Drawing at any zoom reads the finest level with at least a bin per pixel,
+    so a pixel merges one or two bins whatever the length of the track, and no
+    audio is decoded.
+*/
+class TrackWaveform : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<TrackWaveform>;
+
+    //Peaks (-127 to 127 is full scale) and RMS (0 to 255 is full scale) of the samples of a bin, and RMS of each band
+    struct Bin
+    {
+        juce::int8 min = 0;
+        juce::int8 max = 0;
+        juce::uint8 rms = 0;
+        juce::uint8 low = 0;
+        juce::uint8 mid = 0;
+        juce::uint8 high = 0;
+    };
+
+    //Builds the levels above the base level
+    TrackWaveform(std::vector<Bin> baseLevel, juce::int64 _lengthInSamples, double _sampleRate);
+
+    //The finest level with bins of at least samplesPerPixel / 2 samples (so a pixel merges at most 2 bins)
+    int getLevelFor(double samplesPerPixel) const;
+    int getNumLevels() const;
+    const std::vector<Bin>& getLevel(int level) const;
+    //Track samples per bin of a level
+    juce::int64 getBinSize(int level) const;
+
+    //Peaks and RMS of track samples [start, end) from the bins of a level
+    Bin getRange(int level, juce::int64 start, juce::int64 end) const;
+
+    juce::int64 getLengthInSamples() const;
+    double getSampleRate() const;
+
+    static constexpr int baseBinSize = 128;
+    //Edges of the bands (Hz), low is under lowBandEdge and high over highBandEdge
+    static constexpr double lowBandEdge = 250.0;
+    static constexpr double highBandEdge = 2500.0;
+
+private:
+    std::vector<std::vector<Bin>> levels;
+    juce::int64 lengthInSamples;
+    double sampleRate;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackWaveform)
+};
+
+//==============================================================================
+/*
+    Waveforms of the decked tracks. A track is analysed once, on a background
+    thread, and its base level is saved in the app data folder (6 bytes per
+    baseBinSize samples, about 500 KB for a 4 minute track), keyed by the
+    path, size and modification time of the file. After that it is read from
+    the disk cache, even after a restart, instead of decoding the track again.
+
+    Listeners (change messages on the message thread) hear when a waveform
+    has become ready, or when a track could not be analysed (it is then not
+    tried again until the app restarts).
+*/
+class WaveformCache : public juce::ChangeBroadcaster
+{
+public:
+    WaveformCache(juce::AudioFormatManager& _formatManager, int _maxTracks);
+    ~WaveformCache() override;
+
+    //The waveform of a track if it is ready, nullptr otherwise (it is then analysed or read from disk in the background)
+    TrackWaveform::Ptr get(const juce::URL& audioURL);
+    //Whether a track could not be read or decoded, get() then always returns nullptr for it
+    bool hasFailed(const juce::URL& audioURL);
+
+    //Where the waveform of a track is saved
+    static juce::File getCacheFileFor(const juce::File& track);
+
+private:
+    class AnalysisJob;
+
+    struct Entry
+    {
+        std::string key;
+        TrackWaveform::Ptr waveform;
+    };
+
+    //Read the saved waveform of a track, or decode and analyse it and save it (on a pool thread)
+    TrackWaveform::Ptr load(const juce::URL& audioURL, juce::ThreadPoolJob& job);
+    TrackWaveform::Ptr analyse(const juce::URL& audioURL, juce::ThreadPoolJob& job);
+    static TrackWaveform::Ptr readFromDisk(const juce::File& track);
+    static bool writeToDisk(const juce::File& track, const TrackWaveform& waveform);
+
+    static std::string getKey(const juce::URL& audioURL);
+
+    juce::AudioFormatManager& formatManager;
+
+    juce::CriticalSection lock;
+    //Most recently used first, up to maxTracks
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+    std::unordered_set<std::string> analysing;
+    std::unordered_set<std::string> failed;
+    int maxTracks;
+
+    juce::ThreadPool analysisPool{ 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformCache)
+};
@@ -0,0 +1,343 @@
+/*
+  ==============================================================================
+
+    LibraryExporter.cpp
+    Created: 10 Oct 2022 2:17:45pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "LibraryExporter.h"
+
+#include <string>
+#include <unordered_set>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <sys/ioctl.h>
+#endif
+#if JUCE_LINUX
+ #include <linux/fs.h>
+#endif
+#if JUCE_MAC
+ #include <sys/clonefile.h>
+#endif
+
+LibraryExporter::LibraryExporter() : juce::Thread("Library export")
+{
+}
+
+LibraryExporter::~LibraryExporter()
+{
+    cancel();
+}
+
+//==============================================================================
+bool LibraryExporter::saveReferences(const juce::File& folder,
+                                     const std::vector<TrackStore::TrackInfo>& tracks,
+                                     const std::vector<juce::File>& roots)
+{
+    if (!folder.createDirectory())
+    {
+        std::cout << "LibraryExporter::saveReferences cannot create " << folder.getFullPathName() << std::endl;
+        return false;
+    }
+
+    return writePlaylist(folder.getChildFile(playlistFileName), tracks)
+        && LibraryIndex::save(folder.getChildFile(LibraryIndex::indexFileName), tracks, roots);
+}
+
+bool LibraryExporter::writePlaylist(const juce::File& playlistFile, const std::vector<TrackStore::TrackInfo>& tracks)
+{
+    juce::MemoryOutputStream text;
+    text << "#EXTM3U\n";
+    for (const auto& track : tracks)
+    {
+        //Tracks in the folder of the playlist are written relative to it, so the folder can be moved
+        auto folder = playlistFile.getParentDirectory();
+        auto path = track.file.isAChildOf(folder) ? track.file.getRelativePathFrom(folder) : track.file.getFullPathName();
+        text << "#EXTINF:" << juce::roundToInt(track.lengthInSeconds) << "," << juce::String(track.title) << "\n" << path << "\n";
+    }
+
+    //Written next to it and moved over, a half written playlist is never read
+    juce::TemporaryFile temp(playlistFile);
+    if (!temp.getFile().replaceWithData(text.getData(), text.getDataSize()))
+    {
+        std::cout << "LibraryExporter::writePlaylist cannot write " << playlistFile.getFullPathName() << std::endl;
+        return false;
+    }
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+std::vector<juce::File> LibraryExporter::readPlaylist(const juce::File& playlistFile)
+{
+    std::vector<juce::File> files;
+    if (!playlistFile.existsAsFile())
+    {
+        return files;
+    }
+
+    juce::StringArray lines;
+    playlistFile.readLines(lines);
+    for (auto line : lines)
+    {
+        line = line.trim();
+        if (line.isEmpty() || line.startsWithChar('#'))   //Comments and track info
+        {
+            continue;
+        }
+        //Absolute, or relative to the playlist
+        files.push_back(playlistFile.getParentDirectory().getChildFile(line));
+    }
+    return files;
+}
+
+//==============================================================================
+void LibraryExporter::startConsolidating(const juce::File& _folder, const std::vector<TrackStore::TrackInfo>& _tracks)
+{
+    cancel();
+
+    folder = _folder;
+    tracks = _tracks;
+    numBytes = 0;
+    for (const auto& track : tracks)
+    {
+        numBytes += track.file.getSize();
+    }
+
+    filesDone = 0;
+    filesLinked = 0;
+    filesFailed = 0;
+    bytesDone = 0;
+    bytesCopied = 0;
+    startTime = juce::Time::getMillisecondCounter();
+    exporting = true;
+
+    startThread();
+    startTimer(250);
+}
+
+void LibraryExporter::cancel()
+{
+    stopTimer();
+    stopThread(4000);
+    exporting = false;
+}
+
+bool LibraryExporter::isExporting() const
+{
+    return exporting;
+}
+
+void LibraryExporter::run()
+{
+    AudioProfiler::nameThread("Library export");
+    OTODESKS_PROFILE_SCOPE("LibraryExporter::consolidate");
+
+    if (!folder.createDirectory())
+    {
+        std::cout << "LibraryExporter::run cannot create " << folder.getFullPathName() << std::endl;
+        filesFailed = (int) tracks.size();
+        filesDone = (int) tracks.size();
+        return;
+    }
+
+    std::vector<TrackStore::TrackInfo> saved;
+    std::unordered_set<std::string> targetNames;
+    for (const auto& track : tracks)
+    {
+        if (threadShouldExit())
+        {
+            return;
+        }
+
+        //Named after its title, numbered when another track of this export has the same one
+        auto name = juce::File::createLegalFileName(juce::String(track.title));
+        auto extension = track.file.getFileExtension();
+        auto fileName = name + extension;
+        for (int n = 2; !targetNames.insert(fileName.toLowerCase().toStdString()).second; ++n)
+        {
+            fileName = name + " (" + juce::String(n) + ")" + extension;
+        }
+
+        auto target = folder.getChildFile(fileName);
+        bool linked = false;
+        if (transfer(track.file, target, linked))
+        {
+            //Indexed as the copy is, so loading the library does not probe it again
+            auto copy = track;
+            copy.file = target;
+            copy.url = juce::URL(target);
+            copy.fileSize = target.getSize();
+            copy.modificationTime = target.getLastModificationTime().toMilliseconds();
+            saved.push_back(copy);
+            filesLinked += linked ? 1 : 0;
+        }
+        else
+        {
+            //Still referenced where it is, so the saved library does not lose it
+            std::cout << "LibraryExporter::run cannot copy " << track.file.getFullPathName() << std::endl;
+            saved.push_back(track);
+            ++filesFailed;
+        }
+        ++filesDone;
+    }
+
+    //The saved library now lists the tracks in its folder, and the ones that could not be put there where they are
+    saveReferences(folder, saved, { folder });
+}
+
+bool LibraryExporter::transfer(const juce::File& source, const juce::File& target, bool& linked)
+{
+    auto size = source.getSize();
+
+    //Already there from an earlier export (or the track is in the folder already)
+    if (target == source || (target.getSize() == size && target.getLastModificationTime() == source.getLastModificationTime()))
+    {
+        bytesDone += size;
+        linked = true;
+        return true;
+    }
+
+    if (target.exists() && !target.deleteFile())
+    {
+        return false;
+    }
+
+    if (cloneOrLink(source, target))
+    {
+        bytesDone += size;
+        linked = true;
+        return true;
+    }
+
+    return copyInBlocks(source, target);
+}
+
+bool LibraryExporter::cloneOrLink(const juce::File& source, const juce::File& target)
+{
+    auto from = source.getFullPathName().toRawUTF8();
+    auto to = target.getFullPathName().toRawUTF8();
+
+   #if JUCE_MAC
+    //APFS clone
+    if (clonefile(from, to, 0) == 0)
+    {
+        return true;
+    }
+   #endif
+
+   #if JUCE_LINUX && defined (FICLONE)
+    //Reflink (Btrfs, XFS, ...)
+    int in = open(from, O_RDONLY | O_CLOEXEC);
+    if (in >= 0)
+    {
+        int out = open(to, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        bool cloned = out >= 0 && ioctl(out, FICLONE, in) == 0;
+        if (out >= 0)
+        {
+            close(out);
+            if (!cloned)
+            {
+                unlink(to);
+            }
+        }
+        close(in);
+        if (cloned)
+        {
+            return true;
+        }
+    }
+   #endif
+
+   #if JUCE_LINUX || JUCE_MAC
+    //Hard link (same volume)
+    if (link(from, to) == 0)
+    {
+        return true;
+    }
+   #else
+    juce::ignoreUnused(from, to);
+   #endif
+
+    return false;
+}
+
+bool LibraryExporter::copyInBlocks(const juce::File& source, const juce::File& target)
+{
+    juce::FileInputStream in(source);
+    if (!in.openedOk())
+    {
+        return false;
+    }
+
+    //Written next to it and moved over, a half copied track is never left behind
+    juce::TemporaryFile temp(target);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+        {
+            return false;
+        }
+
+        juce::HeapBlock<char> block((size_t) blockSize);
+        while (!in.isExhausted())
+        {
+            if (threadShouldExit())
+            {
+                return false;
+            }
+
+            auto numRead = in.read(block, blockSize);
+            if (numRead <= 0 || !out.write(block, (size_t) numRead))
+            {
+                return false;
+            }
+            bytesDone += numRead;
+            bytesCopied += numRead;
+        }
+
+        out.flush();
+        if (out.getStatus().failed())
+        {
+            return false;
+        }
+    }
+
+    if (!temp.overwriteTargetFileWithTemporary())
+    {
+        return false;
+    }
+    //Same time as the source, so an export again finds it there
+    target.setLastModificationTime(source.getLastModificationTime());
+    return true;
+}
+
+//==============================================================================
+void LibraryExporter::timerCallback()
+{
+    Progress progress;
+    progress.filesDone = filesDone;
+    progress.numFiles = (int) tracks.size();
+    progress.bytesDone = bytesDone;
+    progress.numBytes = numBytes;
+    progress.filesLinked = filesLinked;
+    progress.filesFailed = filesFailed;
+
+    auto elapsed = (juce::Time::getMillisecondCounter() - startTime) / 1000.0;
+    progress.bytesPerSecond = elapsed > 0 ? (double) bytesCopied / elapsed : 0;
+
+    progress.finished = !isThreadRunning();
+    if (progress.finished)
+    {
+        stopTimer();
+        exporting = false;
+    }
+
+    if (onProgress != nullptr)
+    {
+        onProgress(progress);
+    }
+}
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    LibraryExporter.h
+    Created: 10 Oct 2022 2:17:45pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "LibraryIndex.h"
+
+//==============================================================================
+/*
+    Saves a library. A saved library is a folder with a playlist (M3U8, which
+    other players read too) and a library index of its tracks; saving writes
+    only these, the tracks stay where they are and are referenced.
+
+    Consolidating puts the tracks themselves in the folder as well, on a
+    background I/O thread: a file is cloned (reflink, which shares the data
+    until either copy changes) where the file system can, hard linked where
+    it is on the same volume, and copied in blocks otherwise. The playlist
+    and index are then written again for the tracks in the folder (a track
+    that could not be put there stays referenced where it is). Progress and
+    throughput are reported on the message thread a few times a second.
+*/
+class LibraryExporter : public juce::Thread,
+                        public juce::Timer
+{
+public:
+    LibraryExporter();
+    ~LibraryExporter() override;
+
+    //Write the playlist and the index of tracks (referenced where they are) into a folder
+    static bool saveReferences(const juce::File& folder,
+                               const std::vector<TrackStore::TrackInfo>& tracks,
+                               const std::vector<juce::File>& roots);
+
+    //Write a playlist of tracks, paths of tracks in its folder are written relative to it
+    static bool writePlaylist(const juce::File& playlistFile, const std::vector<TrackStore::TrackInfo>& tracks);
+    //Files a playlist lists, in order
+    static std::vector<juce::File> readPlaylist(const juce::File& playlistFile);
+
+    //Put the tracks in a folder in the background (an export that is running is cancelled first)
+    void startConsolidating(const juce::File& folder, const std::vector<TrackStore::TrackInfo>& tracks);
+    void cancel();
+    bool isExporting() const;
+
+    struct Progress
+    {
+        int filesDone = 0;
+        int numFiles = 0;
+        juce::int64 bytesDone = 0;
+        juce::int64 numBytes = 0;
+        //Bytes actually copied per second (cloned and linked files take no time)
+        double bytesPerSecond = 0;
+        int filesLinked = 0;
+        int filesFailed = 0;
+        bool finished = false;
+    };
+    //Called on the message thread while consolidating, and when it has finished
+    std::function<void(const Progress&)> onProgress;
+
+    //Virtual pure functions from Thread (consolidates)
+    void run() override;
+    //Virtual pure functions from Timer (reports the progress)
+    void timerCallback() override;
+
+    //Names of the playlist and index of a saved library
+    static constexpr const char* playlistFileName = "Library.m3u8";
+
+private:
+    //Put a file at target by the cheapest way the file system has, returns false if it could not be done at all
+    bool transfer(const juce::File& source, const juce::File& target, bool& linked);
+    static bool cloneOrLink(const juce::File& source, const juce::File& target);
+    bool copyInBlocks(const juce::File& source, const juce::File& target);
+
+    juce::File folder;
+    std::vector<TrackStore::TrackInfo> tracks;
+
+    std::atomic<int> filesDone{ 0 };
+    std::atomic<int> filesLinked{ 0 };
+    std::atomic<int> filesFailed{ 0 };
+    std::atomic<juce::int64> bytesDone{ 0 };
+    std::atomic<juce::int64> bytesCopied{ 0 };
+    juce::int64 numBytes = 0;
+    juce::uint32 startTime = 0;
+    bool exporting = false;
+
+    static constexpr int blockSize = 1024 * 1024;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryExporter)
+};
@@ -0,0 +1,310 @@
+/*
+  ==============================================================================
+
+    LibraryIndex.cpp
+    Created: 5 Oct 2022 10:03:37am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "LibraryIndex.h"
+
+namespace
+{
+    //Index layout (little endian): header, track records, root records, strings
+    const char* const indexMagic = "OLIB";
+    constexpr int indexVersion = 2;
+    constexpr size_t headerSize = 20;   //Magic, version, number of tracks, number of roots, size of the strings
+    constexpr size_t recordSize = 56;   //Path and title (offset and length in the strings), file size, modification time, length, sample rate, hash
+    constexpr size_t rootSize = 8;      //Path (offset and length in the strings)
+
+    //Version 1 has no roots and no hashes (its tracks are read with a hash of 0)
+    constexpr size_t headerSizeV1 = 16;
+    constexpr size_t recordSizeV1 = 48;
+
+    juce::uint32 readUInt32(const char* data)
+    {
+        return juce::ByteOrder::littleEndianInt(data);
+    }
+
+    juce::int64 readInt64(const char* data)
+    {
+        return (juce::int64) juce::ByteOrder::littleEndianInt64(data);
+    }
+
+    double readDouble(const char* data)
+    {
+        auto bits = juce::ByteOrder::littleEndianInt64(data);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
+
+//==============================================================================
+LibraryIndex::LibraryIndex()
+{
+}
+
+LibraryIndex::~LibraryIndex()
+{
+}
+
+bool LibraryIndex::load(const juce::File& indexFile)
+{
+    OTODESKS_PROFILE_SCOPE("LibraryIndex::load");
+
+    tracks.clear();
+    roots.clear();
+    trackOfPath.clear();
+
+    if (!indexFile.existsAsFile())
+    {
+        return false;
+    }
+
+    juce::MemoryMappedFile mapped(indexFile, juce::MemoryMappedFile::readOnly);
+    auto* data = static_cast<const char*>(mapped.getData());
+    auto size = mapped.getSize();
+    int version = size >= headerSizeV1 ? (int) readUInt32(data + 4) : 0;
+    if (data == nullptr || size < headerSizeV1 || std::memcmp(data, indexMagic, 4) != 0 || (version != 1 && version != indexVersion))
+    {
+        std::cout << "LibraryIndex::load not an index of this version " << indexFile.getFullPathName() << std::endl;
+        return false;
+    }
+
+    size_t header = version == 1 ? headerSizeV1 : headerSize;
+    size_t record = version == 1 ? recordSizeV1 : recordSize;
+    if (size < header)
+    {
+        std::cout << "LibraryIndex::load damaged index " << indexFile.getFullPathName() << std::endl;
+        return false;
+    }
+    size_t numTracks = readUInt32(data + 8);
+    size_t numRoots = version == 1 ? 0 : readUInt32(data + 12);
+    size_t stringsSize = readUInt32(data + header - 4);
+    if (size != header + numTracks * record + numRoots * rootSize + stringsSize)
+    {
+        std::cout << "LibraryIndex::load damaged index " << indexFile.getFullPathName() << std::endl;
+        return false;
+    }
+
+    const char* records = data + header;
+    const char* rootRecords = records + numTracks * record;
+    const char* strings = rootRecords + numRoots * rootSize;
+    auto getString = [strings, stringsSize](const char* field, juce::String& result)
+    {
+        size_t offset = readUInt32(field);
+        size_t length = readUInt32(field + 4);
+        if (offset + length > stringsSize)
+        {
+            return false;
+        }
+        result = juce::String::fromUTF8(strings + offset, (int) length);
+        return true;
+    };
+
+    tracks.reserve(numTracks);
+    trackOfPath.reserve(numTracks);
+    for (size_t i = 0; i < numTracks; ++i)
+    {
+        const char* fields = records + i * record;
+
+        juce::String path, title;
+        if (!getString(fields, path) || !getString(fields + 8, title) || !juce::File::isAbsolutePath(path))
+        {
+            std::cout << "LibraryIndex::load damaged index " << indexFile.getFullPathName() << std::endl;
+            tracks.clear();
+            trackOfPath.clear();
+            return false;
+        }
+
+        TrackStore::TrackInfo track;
+        track.file = juce::File(path);
+        track.url = juce::URL(track.file);
+        track.title = title.toStdString();
+        track.fileSize = readInt64(fields + 16);
+        track.modificationTime = readInt64(fields + 24);
+        track.lengthInSeconds = readDouble(fields + 32);
+        track.sampleRate = readDouble(fields + 40);
+        track.contentHash = version == 1 ? 0 : (juce::uint64) readInt64(fields + 48);
+
+        trackOfPath[path.toStdString()] = tracks.size();
+        tracks.push_back(std::move(track));
+    }
+
+    for (size_t i = 0; i < numRoots; ++i)
+    {
+        juce::String path;
+        if (getString(rootRecords + i * rootSize, path) && juce::File::isAbsolutePath(path))
+        {
+            roots.push_back(juce::File(path));
+        }
+    }
+    return true;
+}
+
+const std::vector<TrackStore::TrackInfo>& LibraryIndex::getTracks() const
+{
+    return tracks;
+}
+
+const std::vector<juce::File>& LibraryIndex::getRoots() const
+{
+    return roots;
+}
+
+const TrackStore::TrackInfo* LibraryIndex::findUnchanged(const juce::File& file) const
+{
+    auto it = trackOfPath.find(file.getFullPathName().toStdString());
+    if (it == trackOfPath.end())
+    {
+        return nullptr;
+    }
+
+    const auto& track = tracks[it->second];
+    if (track.fileSize != file.getSize() || track.modificationTime != file.getLastModificationTime().toMilliseconds())
+    {
+        return nullptr;
+    }
+    return &track;
+}
+
+//==============================================================================
+bool LibraryIndex::save(const juce::File& indexFile,
+                        const std::vector<TrackStore::TrackInfo>& tracks,
+                        const std::vector<juce::File>& roots)
+{
+    OTODESKS_PROFILE_SCOPE("LibraryIndex::save");
+
+    if (!indexFile.getParentDirectory().createDirectory())
+    {
+        std::cout << "LibraryIndex::save cannot create " << indexFile.getParentDirectory().getFullPathName() << std::endl;
+        return false;
+    }
+
+    //Strings first, so the records know where theirs are
+    juce::MemoryOutputStream strings;
+    std::vector<juce::uint32> offsets;
+    offsets.reserve(tracks.size() * 4 + roots.size() * 2);
+    auto addString = [&strings, &offsets](const juce::String& text)
+    {
+        auto utf8 = text.toUTF8();
+        auto length = utf8.sizeInBytes() - 1;
+        offsets.push_back((juce::uint32) strings.getDataSize());
+        offsets.push_back((juce::uint32) length);
+        strings.write(utf8.getAddress(), length);
+    };
+    for (const auto& track : tracks)
+    {
+        addString(track.file.getFullPathName());
+        addString(juce::String(track.title));
+    }
+    for (const auto& root : roots)
+    {
+        addString(root.getFullPathName());
+    }
+
+    //Written next to it and moved over, a half written index is never read
+    juce::TemporaryFile temp(indexFile);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+        {
+            return false;
+        }
+
+        out.write(indexMagic, 4);
+        out.writeInt(indexVersion);
+        out.writeInt((int) tracks.size());
+        out.writeInt((int) roots.size());
+        out.writeInt((int) strings.getDataSize());
+        for (size_t i = 0; i < tracks.size(); ++i)
+        {
+            for (int field = 0; field < 4; ++field)
+            {
+                out.writeInt((int) offsets[i * 4 + (size_t) field]);
+            }
+            out.writeInt64(tracks[i].fileSize);
+            out.writeInt64(tracks[i].modificationTime);
+            out.writeDouble(tracks[i].lengthInSeconds);
+            out.writeDouble(tracks[i].sampleRate);
+            out.writeInt64((juce::int64) tracks[i].contentHash);
+        }
+        for (size_t i = 0; i < roots.size(); ++i)
+        {
+            auto first = tracks.size() * 4 + i * 2;
+            out.writeInt((int) offsets[first]);
+            out.writeInt((int) offsets[first + 1]);
+        }
+        out.write(strings.getData(), strings.getDataSize());
+        out.flush();
+        if (out.getStatus().failed())
+        {
+            return false;
+        }
+    }
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+bool LibraryIndex::probe(juce::AudioFormatManager& formatManager, const juce::File& file, TrackStore::TrackInfo& track)
+{
+    //Check if it is in audio format
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->sampleRate <= 0)   //Bad file
+    {
+        return false;
+    }
+
+    track.file = file;
+    track.url = juce::URL(file);
+    track.title = file.getFileNameWithoutExtension().toStdString();
+    track.lengthInSeconds = reader->lengthInSamples / reader->sampleRate;
+    track.sampleRate = reader->sampleRate;
+    track.fileSize = file.getSize();
+    track.modificationTime = file.getLastModificationTime().toMilliseconds();
+    track.contentHash = quickHash(file);
+    return true;
+}
+
+juce::uint64 LibraryIndex::quickHash(const juce::File& file)
+{
+    //FNV-1a over the size and both ends of the file (tags at either end change the hash too)
+    juce::uint64 hash = 14695981039346656037ull;
+    auto add = [&hash](const void* data, size_t numBytes)
+    {
+        auto* bytes = static_cast<const juce::uint8*>(data);
+        for (size_t i = 0; i < numBytes; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+
+    auto size = file.getSize();
+    add(&size, sizeof(size));
+
+    juce::FileInputStream in(file);
+    if (!in.openedOk())
+    {
+        return hash;
+    }
+
+    juce::HeapBlock<char> block((size_t) quickHashBytes);
+    auto numRead = in.read(block, quickHashBytes);
+    add(block, (size_t) juce::jmax(0, numRead));
+
+    //The last bytes (or the rest, for a short file)
+    if (size > 2 * quickHashBytes)
+    {
+        in.setPosition(size - quickHashBytes);
+    }
+    numRead = in.read(block, quickHashBytes);
+    add(block, (size_t) juce::jmax(0, numRead));
+    return hash;
+}
+
+juce::File LibraryIndex::getAppLibraryFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory).getChildFile("Otodesks").getChildFile(indexFileName);
+}
@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+    LibraryScanner.cpp
+    Created: 6 Oct 2022 3:51:22pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "LibraryScanner.h"
+#include "LibraryExporter.h"
+
+#include <string>
+#include <unordered_set>
+
+//==============================================================================
+class LibraryScanner::ProbeJob : public juce::ThreadPoolJob
+{
+public:
+    ProbeJob(LibraryScanner& _owner, std::vector<juce::File> _files) : juce::ThreadPoolJob("Library probe"),
+                                                                       owner(_owner),
+                                                                       files(std::move(_files))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        AudioProfiler::nameThread("Library probe");
+        OTODESKS_PROFILE_SCOPE("LibraryScanner::probe");
+
+        std::vector<TrackStore::TrackInfo> tracks;
+        for (const auto& file : files)
+        {
+            if (shouldExit())
+            {
+                return jobHasFinished;
+            }
+
+            TrackStore::TrackInfo track;
+            if (LibraryIndex::probe(owner.formatManager, file, track))
+            {
+                tracks.push_back(std::move(track));
+            }
+        }
+
+        owner.addFound(tracks, (int) files.size());
+        return jobHasFinished;
+    }
+
+private:
+    LibraryScanner& owner;
+    std::vector<juce::File> files;
+};
+
+//==============================================================================
+class LibraryScanner::WalkJob : public juce::ThreadPoolJob
+{
+public:
+    WalkJob(LibraryScanner& _owner, const juce::File& _folder) : juce::ThreadPoolJob("Library walk"),
+                                                                 owner(_owner),
+                                                                 folder(_folder)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        AudioProfiler::nameThread("Library walk");
+        OTODESKS_PROFILE_SCOPE("LibraryScanner::walk");
+
+        //The index Save Library left in the folder, if any
+        LibraryIndex index;
+        index.load(folder.getChildFile(LibraryIndex::indexFileName));
+
+        std::vector<TrackStore::TrackInfo> indexed;
+        std::vector<juce::File> toProbe;
+        auto addFile = [&](const juce::File& file)
+        {
+            ++owner.filesFound;
+
+            //Indexed and unchanged since, nothing to open
+            if (auto* track = index.findUnchanged(file))
+            {
+                indexed.push_back(*track);
+                if ((int) indexed.size() == 16 * filesPerJob)
+                {
+                    owner.addFound(indexed, (int) indexed.size());
+                }
+                return;
+            }
+
+            toProbe.push_back(file);
+            if ((int) toProbe.size() == filesPerJob)
+            {
+                owner.scanPool.addJob(new ProbeJob(owner, std::move(toProbe)), true);
+                toProbe.clear();
+            }
+        };
+
+        //A library saved without its tracks references them where they are, in its playlist and index
+        std::unordered_set<std::string> referenced;
+        auto addReferenced = [&](const juce::File& file)
+        {
+            if (!file.isAChildOf(folder) && file.existsAsFile() && referenced.insert(file.getFullPathName().toStdString()).second)
+            {
+                addFile(file);
+            }
+        };
+        for (const auto& file : LibraryExporter::readPlaylist(folder.getChildFile(LibraryExporter::playlistFileName)))
+        {
+            addReferenced(file);
+        }
+        for (const auto& track : index.getTracks())
+        {
+            addReferenced(track.file);
+        }
+
+        for (const auto& entry : juce::RangedDirectoryIterator(folder, true, owner.formatManager.getWildcardForAllFormats(), juce::File::findFiles))
+        {
+            if (shouldExit())
+            {
+                owner.walking = false;
+                return jobHasFinished;
+            }
+
+            addFile(entry.getFile());
+        }
+
+        if (!toProbe.empty())
+        {
+            owner.scanPool.addJob(new ProbeJob(owner, std::move(toProbe)), true);
+        }
+        owner.addFound(indexed, (int) indexed.size());
+
+        owner.walking = false;
+        return jobHasFinished;
+    }
+
+private:
+    LibraryScanner& owner;
+    juce::File folder;
+};
+
+//==============================================================================
+LibraryScanner::LibraryScanner(juce::AudioFormatManager& _formatManager) : formatManager(_formatManager)
+{
+}
+
+LibraryScanner::~LibraryScanner()
+{
+    cancel();
+}
+
+void LibraryScanner::start(const juce::File& folder)
+{
+    cancel();
+
+    walking = true;
+    filesFound = 0;
+    filesDone = 0;
+    scanning = true;
+
+    scanPool.addJob(new WalkJob(*this, folder), true);
+    startTimer(100);
+}
+
+void LibraryScanner::cancel()
+{
+    stopTimer();
+    scanPool.removeAllJobs(true, 4000);
+
+    const juce::ScopedLock sl(lock);
+    found.clear();
+    walking = false;
+    scanning = false;
+}
+
+bool LibraryScanner::isScanning() const
+{
+    return scanning;
+}
+
+void LibraryScanner::addFound(std::vector<TrackStore::TrackInfo>& tracks, int numFilesDone)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        found.insert(found.end(), std::make_move_iterator(tracks.begin()), std::make_move_iterator(tracks.end()));
+    }
+    tracks.clear();
+
+    //Counted after the tracks are in, so when every file is done every track is too
+    filesDone += numFilesDone;
+}
+
+void LibraryScanner::timerCallback()
+{
+    //Checked before taking the tracks, anything found before it is in this batch
+    bool finished = !walking && filesDone == filesFound;
+
+    std::vector<TrackStore::TrackInfo> batch;
+    {
+        const juce::ScopedLock sl(lock);
+        batch.swap(found);
+    }
+
+    if (!batch.empty() && onTracksFound != nullptr)
+    {
+        onTracksFound(batch);
+    }
+
+    if (finished)
+    {
+        stopTimer();
+        scanning = false;
+    }
+
+    if (onProgress != nullptr)
+    {
+        onProgress(filesDone, filesFound, finished);
+    }
+}
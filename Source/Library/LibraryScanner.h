@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    LibraryScanner.h
+    Created: 6 Oct 2022 3:51:22pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "LibraryIndex.h"
+
+//==============================================================================
+/*
+    Scans a folder and all the folders in it for tracks, off the message
+    thread. One job walks the tree and hands the audio files (by extension)
+    to probe jobs, filesPerJob at a time, on a pool with a thread per core;
+    files the index of the folder has, unchanged, are not opened at all.
+
+    Found tracks are handed over on the message thread in batches, a few
+    times a second, with the progress, so the library fills in while the
+    scan goes on. A scan can be cancelled at any time.
+*/
+class LibraryScanner : public juce::Timer
+{
+public:
+    LibraryScanner(juce::AudioFormatManager& _formatManager);
+    ~LibraryScanner() override;
+
+    //Scan a folder (a scan that is running is cancelled first)
+    void start(const juce::File& folder);
+    //Stop the scan, tracks not handed over yet are dropped
+    void cancel();
+    bool isScanning() const;
+
+    //Called on the message thread with each batch of tracks found
+    std::function<void(const std::vector<TrackStore::TrackInfo>&)> onTracksFound;
+    //Called on the message thread with the files done and found so far, and when the scan has finished
+    std::function<void(int filesDone, int filesFound, bool finished)> onProgress;
+
+    //Virtual pure functions from Timer (hands the tracks found over)
+    void timerCallback() override;
+
+    static constexpr int filesPerJob = 32;
+
+private:
+    class WalkJob;
+    class ProbeJob;
+
+    //Add tracks found by a job, and count the files it has done (any thread)
+    void addFound(std::vector<TrackStore::TrackInfo>& tracks, int numFilesDone);
+
+    juce::AudioFormatManager& formatManager;
+
+    std::atomic<bool> walking{ false };
+    std::atomic<int> filesFound{ 0 };
+    std::atomic<int> filesDone{ 0 };
+
+    juce::CriticalSection lock;
+    std::vector<TrackStore::TrackInfo> found;
+
+    bool scanning = false;
+
+    juce::ThreadPool scanPool{ juce::jmax(1, juce::SystemStats::getNumCpus()) };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryScanner)
+};
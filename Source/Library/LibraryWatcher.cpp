@@ -0,0 +1,493 @@
+/*
+  ==============================================================================
+
+    LibraryWatcher.cpp
+    Created: 8 Oct 2022 11:34:08am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "LibraryWatcher.h"
+#include "../Engine/SeekIndex.h"
+#include "../Engine/WaveformCache.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#if JUCE_LINUX
+ #include <sys/inotify.h>
+ #include <poll.h>
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+class LibraryWatcher::WatchThread : public juce::Thread
+{
+public:
+    WatchThread(LibraryWatcher& _owner, const std::vector<juce::File>& _roots) : juce::Thread("Library watch"),
+                                                                                 owner(_owner),
+                                                                                 roots(_roots)
+    {
+    }
+
+    ~WatchThread() override
+    {
+        stopThread(2000);
+    }
+
+    void run() override
+    {
+       #if JUCE_LINUX
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0)
+        {
+            std::cout << "LibraryWatcher::WatchThread inotify is not available" << std::endl;
+            return;
+        }
+
+        for (const auto& root : roots)
+        {
+            watchTree(root);
+        }
+
+        alignas(inotify_event) char events[16 * 1024];
+        while (!threadShouldExit())
+        {
+            pollfd ready{ fd, POLLIN, 0 };
+            if (poll(&ready, 1, 250) <= 0)
+            {
+                continue;
+            }
+
+            auto numBytes = read(fd, events, sizeof(events));
+            for (ssize_t at = 0; at < numBytes; )
+            {
+                auto* event = reinterpret_cast<const inotify_event*>(events + at);
+                at += (ssize_t) (sizeof(inotify_event) + event->len);
+
+                //Events were lost, every root has to be looked over
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    for (const auto& root : roots)
+                    {
+                        owner.pathChanged(root);
+                    }
+                    continue;
+                }
+
+                auto folder = folders.find(event->wd);
+                if (folder == folders.end())
+                {
+                    continue;
+                }
+
+                if (event->mask & IN_IGNORED)   //Its folder is gone
+                {
+                    folders.erase(folder);
+                    continue;
+                }
+
+                if (event->len == 0)
+                {
+                    continue;
+                }
+
+                auto path = folder->second.getChildFile(juce::String::fromUTF8(event->name));
+                //A folder that comes in is watched too, and everything in it has changed
+                if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+                {
+                    watchTree(path);
+                }
+                owner.pathChanged(path);
+            }
+        }
+
+        close(fd);
+       #endif
+    }
+
+private:
+   #if JUCE_LINUX
+    //Watch a folder and every folder in it (inotify watches are not recursive)
+    void watchTree(const juce::File& folder)
+    {
+        addWatch(folder);
+        for (const auto& entry : juce::RangedDirectoryIterator(folder, true, "*", juce::File::findDirectories))
+        {
+            addWatch(entry.getFile());
+        }
+    }
+
+    void addWatch(const juce::File& folder)
+    {
+        int wd = inotify_add_watch(fd, folder.getFullPathName().toRawUTF8(),
+                                   IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB);
+        if (wd >= 0)
+        {
+            folders[wd] = folder;
+        }
+        else
+        {
+            std::cout << "LibraryWatcher::WatchThread cannot watch " << folder.getFullPathName() << std::endl;
+        }
+    }
+
+    int fd = -1;
+    std::unordered_map<int, juce::File> folders;
+   #endif
+
+    LibraryWatcher& owner;
+    std::vector<juce::File> roots;
+};
+
+//==============================================================================
+class LibraryWatcher::RescanJob : public juce::ThreadPoolJob
+{
+public:
+    RescanJob(LibraryWatcher& _owner,
+              std::vector<juce::File> _paths,
+              std::vector<std::pair<TrackStore::TrackId, TrackStore::TrackInfo>> _known) : juce::ThreadPoolJob("Library rescan"),
+                                                                                           owner(_owner),
+                                                                                           paths(std::move(_paths)),
+                                                                                           known(std::move(_known))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        AudioProfiler::nameThread("Library rescan");
+        OTODESKS_PROFILE_SCOPE("LibraryWatcher::rescan");
+
+        std::unique_ptr<Changes> changes(new Changes());
+
+        //Audio files that are there now under the changed paths
+        juce::WildcardFileFilter audioFiles(owner.formatManager.getWildcardForAllFormats(), {}, {});
+        std::vector<juce::File> present;
+        std::unordered_set<std::string> unmatched;
+        auto addPresent = [&](const juce::File& file)
+        {
+            if (unmatched.insert(file.getFullPathName().toStdString()).second)
+            {
+                present.push_back(file);
+            }
+        };
+        for (const auto& path : paths)
+        {
+            if (path.isDirectory())
+            {
+                for (const auto& entry : juce::RangedDirectoryIterator(path, true, owner.formatManager.getWildcardForAllFormats(), juce::File::findFiles))
+                {
+                    addPresent(entry.getFile());
+                }
+            }
+            else if (path.existsAsFile() && audioFiles.isFileSuitable(path))
+            {
+                addPresent(path);
+            }
+        }
+
+        //Tracks of the library under the changed paths: unchanged, changed, or gone
+        std::unordered_multimap<juce::uint64, size_t> goneByHash;
+        for (size_t i = 0; i < known.size(); ++i)
+        {
+            if (shouldExit())
+            {
+                return jobHasFinished;
+            }
+
+            const auto& track = known[i].second;
+            auto path = track.file.getFullPathName().toStdString();
+            if (unmatched.erase(path) != 0)
+            {
+                if (track.file.getSize() == track.fileSize && track.file.getLastModificationTime().toMilliseconds() == track.modificationTime)
+                {
+                    continue;
+                }
+
+                TrackStore::TrackInfo probed;
+                if (LibraryIndex::probe(owner.formatManager, track.file, probed))
+                {
+                    changes->modified.push_back({ known[i].first, probed });
+                }
+                else
+                {
+                    changes->removed.push_back(known[i].first);
+                }
+            }
+            else if (!track.file.existsAsFile())
+            {
+                goneByHash.insert({ track.contentHash, i });
+            }
+        }
+
+        //New files, a gone track with the same hash and size has been moved there
+        for (const auto& file : present)
+        {
+            if (shouldExit())
+            {
+                return jobHasFinished;
+            }
+
+            if (unmatched.count(file.getFullPathName().toStdString()) == 0)
+            {
+                continue;
+            }
+
+            auto hash = LibraryIndex::quickHash(file);
+            auto size = file.getSize();
+            auto range = goneByHash.equal_range(hash);
+            auto gone = std::find_if(range.first, range.second, [this, size](const auto& entry) { return known[entry.second].second.fileSize == size; });
+            if (gone != range.second)
+            {
+                const auto& from = known[gone->second];
+                TrackStore::TrackInfo moved = from.second;
+                moved.file = file;
+                moved.url = juce::URL(file);
+                moved.title = file.getFileNameWithoutExtension().toStdString();
+                moved.modificationTime = file.getLastModificationTime().toMilliseconds();
+
+                //The waveform and seek table go with it
+                WaveformCache::getCacheFileFor(from.second.file).moveFileTo(WaveformCache::getCacheFileFor(file));
+                SeekIndex::getIndexFileFor(from.second.file).moveFileTo(SeekIndex::getIndexFileFor(file));
+
+                changes->moved.push_back({ from.first, moved });
+                goneByHash.erase(gone);
+                continue;
+            }
+
+            TrackStore::TrackInfo track;
+            if (LibraryIndex::probe(owner.formatManager, file, track))
+            {
+                changes->added.push_back(track);
+            }
+        }
+
+        for (const auto& gone : goneByHash)
+        {
+            changes->removed.push_back(known[gone.second].first);
+        }
+
+        const juce::ScopedLock sl(owner.lock);
+        owner.found = std::move(changes);
+        return jobHasFinished;
+    }
+
+private:
+    LibraryWatcher& owner;
+    std::vector<juce::File> paths;
+    std::vector<std::pair<TrackStore::TrackId, TrackStore::TrackInfo>> known;
+};
+
+//==============================================================================
+LibraryWatcher::LibraryWatcher(juce::AudioFormatManager& _formatManager, TrackStore& _tracks) : formatManager(_formatManager),
+                                                                                                tracks(_tracks)
+{
+    for (int row = 0; row < tracks.getNumRows(); ++row)
+    {
+        trackAdded(tracks.getIdAtRow(row));
+    }
+    tracks.addListener(this);
+}
+
+LibraryWatcher::~LibraryWatcher()
+{
+    stop();
+    tracks.removeListener(this);
+}
+
+//==============================================================================
+void LibraryWatcher::trackAdded(TrackStore::TrackId id)
+{
+    auto path = tracks.getFile(id).getFullPathName().toStdString();
+    idOfPath[path] = id;
+    pathOfId[id] = std::move(path);
+}
+
+void LibraryWatcher::trackChanged(TrackStore::TrackId id)
+{
+    //Moved tracks change their path
+    trackRemoved(id);
+    trackAdded(id);
+}
+
+void LibraryWatcher::trackRemoved(TrackStore::TrackId id)
+{
+    auto it = pathOfId.find(id);
+    if (it == pathOfId.end())
+    {
+        return;
+    }
+
+    auto path = idOfPath.find(it->second);
+    if (path != idOfPath.end() && path->second == id)
+    {
+        idOfPath.erase(path);
+    }
+    pathOfId.erase(it);
+}
+
+void LibraryWatcher::tracksCleared()
+{
+    idOfPath.clear();
+    pathOfId.clear();
+}
+
+void LibraryWatcher::watch(const std::vector<juce::File>& folders, bool rescanNow)
+{
+    stop();
+
+    roots = folders;
+    if (roots.empty())
+    {
+        return;
+    }
+
+   #if JUCE_LINUX
+    watchThread.reset(new WatchThread(*this, roots));
+    watchThread->startThread();
+   #endif
+
+    if (rescanNow)
+    {
+        for (const auto& root : roots)
+        {
+            pathChanged(root);
+        }
+    }
+
+    lastPollTime = juce::Time::getMillisecondCounter();
+    startTimer(250);
+}
+
+void LibraryWatcher::stop()
+{
+    stopTimer();
+    watchThread.reset();
+    rescanPool.removeAllJobs(true, 4000);
+
+    const juce::ScopedLock sl(lock);
+    changedPaths.clear();
+    found.reset();
+    rescanning = false;
+}
+
+void LibraryWatcher::pathChanged(const juce::File& path)
+{
+    const juce::ScopedLock sl(lock);
+    changedPaths.insert(path.getFullPathName().toStdString());
+    lastChangeTime = juce::Time::getMillisecondCounter();
+}
+
+void LibraryWatcher::timerCallback()
+{
+    auto now = juce::Time::getMillisecondCounter();
+
+   #if ! JUCE_LINUX
+    //No change notifications here, the whole tree is looked over now and then
+    if (now - lastPollTime > (juce::uint32) pollSeconds * 1000)
+    {
+        lastPollTime = now;
+        for (const auto& root : roots)
+        {
+            pathChanged(root);
+        }
+    }
+   #endif
+
+    std::unique_ptr<Changes> changes;
+    std::vector<juce::File> paths;
+    {
+        const juce::ScopedLock sl(lock);
+        changes = std::move(found);
+
+        //Wait for the changes to settle (a file being copied changes many times)
+        if (!rescanning && !changedPaths.empty() && now - lastChangeTime > (juce::uint32) settleMilliseconds)
+        {
+            for (const auto& path : changedPaths)
+            {
+                paths.push_back(juce::File(path));
+            }
+            changedPaths.clear();
+        }
+    }
+
+    if (changes != nullptr)
+    {
+        applyChanges(*changes);
+        rescanning = false;
+    }
+
+    if (!paths.empty())
+    {
+        startRescan(paths);
+    }
+}
+
+void LibraryWatcher::startRescan(const std::vector<juce::File>& paths)
+{
+    OTODESKS_PROFILE_SCOPE("LibraryWatcher::startRescan");
+
+    //The tracks the changes can touch: at a changed path, or in the run of paths that start with it as a folder
+    std::vector<std::pair<TrackStore::TrackId, TrackStore::TrackInfo>> known;
+    std::unordered_set<TrackStore::TrackId> taken;
+    auto take = [&](TrackStore::TrackId id)
+    {
+        //Under two changed paths (a folder and a file in it) it is compared once
+        if (taken.insert(id).second)
+        {
+            known.push_back({ id, tracks.getInfo(id) });
+        }
+    };
+
+    for (const auto& path : paths)
+    {
+        auto fullPath = path.getFullPathName().toStdString();
+        auto exact = idOfPath.find(fullPath);
+        if (exact != idOfPath.end())
+        {
+            take(exact->second);
+        }
+
+        auto folder = fullPath + juce::File::getSeparatorString().toStdString();
+        for (auto it = idOfPath.lower_bound(folder); it != idOfPath.end() && it->first.compare(0, folder.size(), folder) == 0; ++it)
+        {
+            take(it->second);
+        }
+    }
+
+    rescanning = true;
+    rescanPool.addJob(new RescanJob(*this, paths, std::move(known)), true);
+}
+
+void LibraryWatcher::applyChanges(const Changes& changes)
+{
+    std::vector<TrackStore::TrackInfo> modified;
+    for (const auto& track : changes.modified)
+    {
+        if (tracks.update(track.first, track.second))
+        {
+            modified.push_back(track.second);
+        }
+    }
+
+    for (const auto& track : changes.moved)
+    {
+        tracks.update(track.first, track.second);
+    }
+
+    for (auto id : changes.removed)
+    {
+        tracks.remove(id);
+    }
+
+    if (!changes.added.empty() && onTracksAdded != nullptr)
+    {
+        onTracksAdded(changes.added);
+    }
+
+    if (!modified.empty() && onTracksModified != nullptr)
+    {
+        onTracksModified(modified);
+    }
+}
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    LibraryWatcher.h
+    Created: 8 Oct 2022 11:34:08am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "LibraryIndex.h"
+
+//==============================================================================
+/*
+    Keeps the library in step with its folders. On Linux every folder of the
+    tree is watched with inotify; elsewhere the tree is looked over every
+    pollSeconds. Changed paths are gathered until nothing has changed for
+    settleMilliseconds, then only they are compared with the library, on a
+    background thread:
+
+    - a track whose size and modification time are the same is left alone,
+      so its length, waveform and seek table are kept,
+    - a changed track is probed again,
+    - a new file with the quickHash (and size) of a track that has gone is
+      that track moved: it keeps its ID, its length is not probed again and
+      its waveform and seek table are moved along with it,
+    - any other new file is probed and added, any other gone track deleted.
+
+    The tracks under a changed path are looked up in a sorted map of the paths
+    of the library (kept in step with the store), so a change costs the tracks
+    it touches, not a pass over the library. The track store is changed on the
+    message thread.
+*/
+class LibraryWatcher : public juce::Timer,
+                       private TrackStore::Listener
+{
+public:
+    LibraryWatcher(juce::AudioFormatManager& _formatManager, TrackStore& _tracks);
+    ~LibraryWatcher() override;
+
+    //Watch these folders instead of the ones before, with rescanNow they are compared with the library straight away
+    void watch(const std::vector<juce::File>& folders, bool rescanNow);
+    void stop();
+
+    //Called on the message thread with the tracks added, and the tracks changed (probed again) in place
+    std::function<void(const std::vector<TrackStore::TrackInfo>&)> onTracksAdded;
+    std::function<void(const std::vector<TrackStore::TrackInfo>&)> onTracksModified;
+
+    //Virtual pure functions from Timer (starts rescans and applies what they found)
+    void timerCallback() override;
+
+    //Virtual pure functions from TrackStore::Listener (keep the paths of the tracks)
+    void trackAdded(TrackStore::TrackId id) override;
+    void trackChanged(TrackStore::TrackId id) override;
+    void trackRemoved(TrackStore::TrackId id) override;
+    void tracksCleared() override;
+
+    static constexpr int settleMilliseconds = 1000;
+    static constexpr int pollSeconds = 60;
+
+private:
+    class WatchThread;
+    class RescanJob;
+
+    //What a rescan found
+    struct Changes
+    {
+        std::vector<TrackStore::TrackInfo> added;
+        std::vector<std::pair<TrackStore::TrackId, TrackStore::TrackInfo>> modified;
+        std::vector<std::pair<TrackStore::TrackId, TrackStore::TrackInfo>> moved;
+        std::vector<TrackStore::TrackId> removed;
+    };
+
+    //A file or folder has changed (any thread)
+    void pathChanged(const juce::File& path);
+    //Compare the changed paths with the tracks under them in the background
+    void startRescan(const std::vector<juce::File>& paths);
+    void applyChanges(const Changes& changes);
+
+    juce::AudioFormatManager& formatManager;
+    TrackStore& tracks;
+
+    //Full path of every track, sorted so the tracks under a folder are next to each other
+    std::map<std::string, TrackStore::TrackId> idOfPath;
+    std::unordered_map<TrackStore::TrackId, std::string> pathOfId;
+
+    std::vector<juce::File> roots;
+    std::unique_ptr<WatchThread> watchThread;
+
+    juce::CriticalSection lock;
+    std::unordered_set<std::string> changedPaths;
+    juce::uint32 lastChangeTime = 0;
+    std::unique_ptr<Changes> found;
+
+    //A rescan at a time, so each one sees the changes of the one before
+    bool rescanning = false;
+    juce::uint32 lastPollTime = 0;
+
+    juce::ThreadPool rescanPool{ 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryWatcher)
+};
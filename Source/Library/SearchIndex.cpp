@@ -0,0 +1,415 @@
+/*
+  ==============================================================================
+
+    SearchIndex.cpp
+    Created: 11 Oct 2022 9:48:36am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "SearchIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace
+{
+    //How well a query word matches a word of a track, a match in the title counts twice
+    enum MatchScore
+    {
+        typoMatch = 1,
+        insideMatch = 2,
+        prefixMatch = 3,
+        wholeWordMatch = 4
+    };
+
+    const int fieldWeights[SearchIndex::numFields] = { 2, 1, 1 };
+
+    //Typos allowed in a query word of a length
+    int maxEditsFor(size_t length)
+    {
+        return length >= 8 ? 2 : (length >= 4 ? 1 : 0);
+    }
+}
+
+SearchIndex::SearchIndex(TrackStore& _tracks) : tracks(_tracks)
+{
+    rebuild();
+    tracks.addListener(this);
+}
+
+SearchIndex::~SearchIndex()
+{
+    tracks.removeListener(this);
+}
+
+//==============================================================================
+std::vector<std::string> SearchIndex::splitWords(const std::string& text)
+{
+    std::vector<std::string> split;
+    std::string word;
+    for (char c : text)
+    {
+        auto u = (unsigned char) c;
+        //UTF-8 sequences are kept as they are, only ASCII is folded
+        if (u >= 0x80 || std::isalnum(u))
+        {
+            word.push_back((char) (u < 0x80 ? std::tolower(u) : u));
+        }
+        else if (!word.empty())
+        {
+            split.push_back(std::move(word));
+            word.clear();
+        }
+    }
+    if (!word.empty())
+    {
+        split.push_back(std::move(word));
+    }
+    return split;
+}
+
+juce::uint32 SearchIndex::trigramAt(const std::string& word, size_t at)
+{
+    return (juce::uint32) (unsigned char) word[at] << 16 | (juce::uint32) (unsigned char) word[at + 1] << 8 | (juce::uint32) (unsigned char) word[at + 2];
+}
+
+//==============================================================================
+void SearchIndex::trackAdded(TrackStore::TrackId id)
+{
+    addTrack(id);
+}
+
+void SearchIndex::trackChanged(TrackStore::TrackId id)
+{
+    trackRemoved(id);
+    addTrack(id);
+}
+
+void SearchIndex::trackRemoved(TrackStore::TrackId id)
+{
+    auto it = slotOfId.find(id);
+    if (it == slotOfId.end())
+    {
+        return;
+    }
+
+    //Its postings are skipped from now on, and dropped once the dead slots are half of them
+    alive[(size_t) it->second] = 0;
+    slotOfId.erase(it);
+    ++numDead;
+}
+
+void SearchIndex::tracksCleared()
+{
+    idOfSlot.clear();
+    alive.clear();
+    slotOfId.clear();
+    numDead = 0;
+    words.clear();
+    wordIds.clear();
+    sortedWordIds.clear();
+    wordsWithTrigram.clear();
+    postings.clear();
+}
+
+void SearchIndex::rebuild()
+{
+    OTODESKS_PROFILE_SCOPE("SearchIndex::rebuild");
+
+    tracksCleared();
+    for (int row = 0; row < tracks.getNumRows(); ++row)
+    {
+        addTrack(tracks.getIdAtRow(row));
+    }
+}
+
+void SearchIndex::addTrack(TrackStore::TrackId id)
+{
+    if (numDead > 4096 && numDead * 2 > (int) idOfSlot.size())
+    {
+        rebuild();
+        //Indexed by the rebuild already when the store has it in its rows
+        if (slotOfId.count(id) != 0)
+        {
+            return;
+        }
+    }
+
+    int slot = (int) idOfSlot.size();
+    idOfSlot.push_back(id);
+    alive.push_back(1);
+    slotOfId[id] = slot;
+
+    const auto& file = tracks.getFile(id);
+    auto album = file.getParentDirectory();
+    std::string fields[numFields] = { tracks.getTitle(id),
+                                      album.getFileName().toStdString(),
+                                      album.getParentDirectory().getFileName().toStdString() };
+
+    for (int field = 0; field < numFields; ++field)
+    {
+        for (const auto& word : splitWords(fields[field]))
+        {
+            addWord(word, slot, (Field) field);
+        }
+    }
+}
+
+void SearchIndex::addWord(const std::string& word, int slot, Field field)
+{
+    auto it = wordIds.find(word);
+    if (it == wordIds.end())
+    {
+        //A new word of the vocabulary (words stay in it until the index is rebuilt)
+        int wordId = (int) words.size();
+        it = wordIds.emplace(word, wordId).first;
+        sortedWordIds.emplace(word, wordId);
+        words.push_back(word);
+        postings.emplace_back();
+
+        for (size_t at = 0; at + 3 <= word.size(); ++at)
+        {
+            auto& withTrigram = wordsWithTrigram[trigramAt(word, at)];
+            //A trigram twice in a word is counted once
+            if (withTrigram.empty() || withTrigram.back() != wordId)
+            {
+                withTrigram.push_back(wordId);
+            }
+        }
+    }
+
+    auto& posting = postings[(size_t) it->second];
+    auto entry = (juce::uint32) (slot * numFields + field);
+    //A word twice in a field is posted once
+    if (posting.empty() || posting.back() != entry)
+    {
+        posting.push_back(entry);
+    }
+}
+
+//==============================================================================
+void SearchIndex::matchWord(const std::string& queryWord, std::vector<std::pair<int, int>>& matches) const
+{
+    matches.clear();
+    if (wordScores.size() < words.size())
+    {
+        wordScores.resize(words.size(), 0);
+        trigramCounts.resize(words.size(), 0);
+    }
+
+    std::vector<int> touched;
+    auto score = [&](int wordId, int matchScore)
+    {
+        if (wordScores[(size_t) wordId] == 0)
+        {
+            touched.push_back(wordId);
+        }
+        wordScores[(size_t) wordId] = std::max(wordScores[(size_t) wordId], matchScore);
+    };
+
+    //Words starting with it, from the sorted vocabulary
+    for (auto it = sortedWordIds.lower_bound(queryWord); it != sortedWordIds.end() && it->first.compare(0, queryWord.size(), queryWord) == 0; ++it)
+    {
+        score(it->second, it->first.size() == queryWord.size() ? wholeWordMatch : prefixMatch);
+    }
+
+    //Words it is inside of, or a typo away from: the words sharing enough of its trigrams
+    if (queryWord.size() >= 3)
+    {
+        int numTrigrams = 0;
+        std::vector<int> candidates;
+        for (size_t at = 0; at + 3 <= queryWord.size(); ++at)
+        {
+            //A trigram twice in the query word is counted once, as it is in the vocabulary
+            auto trigram = trigramAt(queryWord, at);
+            bool seen = false;
+            for (size_t before = 0; before < at && !seen; ++before)
+            {
+                seen = trigramAt(queryWord, before) == trigram;
+            }
+            if (seen)
+            {
+                continue;
+            }
+            ++numTrigrams;
+
+            auto it = wordsWithTrigram.find(trigram);
+            if (it == wordsWithTrigram.end())
+            {
+                continue;
+            }
+
+            for (int wordId : it->second)
+            {
+                if (trigramCounts[(size_t) wordId]++ == 0)
+                {
+                    candidates.push_back(wordId);
+                }
+            }
+        }
+
+        int maxEdits = maxEditsFor(queryWord.size());
+        //Each edit spoils at most three trigrams
+        int needed = std::max(1, numTrigrams - 3 * maxEdits);
+
+        for (int wordId : candidates)
+        {
+            int count = trigramCounts[(size_t) wordId];
+            trigramCounts[(size_t) wordId] = 0;
+            if (count < needed || wordScores[(size_t) wordId] >= prefixMatch)
+            {
+                continue;
+            }
+
+            const auto& word = words[(size_t) wordId];
+            if (word.find(queryWord) != std::string::npos)
+            {
+                score(wordId, insideMatch);
+            }
+            else if (maxEdits > 0 && std::abs((int) word.size() - (int) queryWord.size()) <= maxEdits
+                     && boundedEditDistance(queryWord, word, maxEdits) <= maxEdits)
+            {
+                score(wordId, typoMatch);
+            }
+        }
+    }
+
+    for (int wordId : touched)
+    {
+        matches.push_back({ wordId, wordScores[(size_t) wordId] });
+        wordScores[(size_t) wordId] = 0;
+    }
+}
+
+int SearchIndex::boundedEditDistance(const std::string& a, const std::string& b, int maxEdits)
+{
+    //Levenshtein, a row at a time, giving up once a whole row is over maxEdits
+    std::vector<int> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j)
+    {
+        row[j] = (int) j;
+    }
+
+    for (size_t i = 1; i <= a.size(); ++i)
+    {
+        int diagonal = row[0];
+        row[0] = (int) i;
+        int best = row[0];
+        for (size_t j = 1; j <= b.size(); ++j)
+        {
+            int above = row[j];
+            row[j] = std::min({ above + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1) });
+            diagonal = above;
+            best = std::min(best, row[j]);
+        }
+        if (best > maxEdits)
+        {
+            return maxEdits + 1;
+        }
+    }
+    return row[b.size()];
+}
+
+std::vector<TrackStore::TrackId> SearchIndex::search(const std::string& query) const
+{
+    OTODESKS_PROFILE_SCOPE("SearchIndex::search");
+
+    std::vector<TrackStore::TrackId> found;
+    auto queryWords = splitWords(query);
+    if (queryWords.empty())
+    {
+        return found;
+    }
+
+    if (slotScores.size() < idOfSlot.size())
+    {
+        slotScores.resize(idOfSlot.size());
+    }
+
+    //The tracks every query word so far has matched, and their scores summed
+    std::vector<int> touched;
+    std::vector<std::pair<int, int>> matches;
+    std::vector<int> matching;
+    int maxScore = 0;
+    for (size_t q = 0; q < queryWords.size(); ++q)
+    {
+        matchWord(queryWords[q], matches);
+
+        //Best match of this query word in each track
+        for (const auto& match : matches)
+        {
+            for (auto entry : postings[(size_t) match.first])
+            {
+                auto slot = entry / numFields;
+                auto& scores = slotScores[slot];
+                if (scores.wordsMatched != (int) q || !alive[slot])
+                {
+                    continue;
+                }
+
+                int score = match.second * fieldWeights[entry % numFields];
+                if (scores.best == 0)
+                {
+                    touched.push_back((int) slot);
+                }
+                scores.best = std::max(scores.best, score);
+            }
+        }
+
+        for (int slot : touched)
+        {
+            auto& scores = slotScores[(size_t) slot];
+            scores.total += scores.best;
+            maxScore = std::max(maxScore, scores.total);
+            ++scores.wordsMatched;
+            scores.best = 0;
+        }
+        if (q == 0)
+        {
+            matching.swap(touched);
+        }
+        touched.clear();
+    }
+
+    //The tracks the first query word matched, in the order they were added: a bit per slot, read back a word at a time
+    //(no sort, a short query can match most of the library)
+    if (slotBits.size() * 64 < idOfSlot.size())
+    {
+        slotBits.resize(idOfSlot.size() / 64 + 1, 0);
+    }
+    for (int slot : matching)
+    {
+        slotBits[(size_t) slot / 64] |= (juce::uint64) 1 << (slot % 64);
+    }
+    matching.clear();
+    for (size_t word = 0; word < slotBits.size(); ++word)
+    {
+        for (auto bits = slotBits[word]; bits != 0; bits &= bits - 1)
+        {
+            matching.push_back((int) (word * 64) + juce::countNumberOfBits((bits & (~bits + 1)) - 1));
+        }
+        slotBits[word] = 0;
+    }
+
+    //Best first, equal ones in the order they were added (a bucket per score, no comparison sort), clearing the scratch space
+    auto numWords = (int) queryWords.size();
+    std::vector<std::vector<TrackStore::TrackId>> byScore((size_t) maxScore + 1);
+    for (int slot : matching)
+    {
+        auto& scores = slotScores[(size_t) slot];
+        if (scores.wordsMatched == numWords)
+        {
+            byScore[(size_t) (maxScore - scores.total)].push_back(idOfSlot[(size_t) slot]);
+        }
+        scores = {};
+    }
+
+    for (const auto& bucket : byScore)
+    {
+        found.insert(found.end(), bucket.begin(), bucket.end());
+    }
+    return found;
+}
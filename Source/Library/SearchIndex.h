@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    SearchIndex.h
+    Created: 11 Oct 2022 9:48:36am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TrackStore.h"
+
+//==============================================================================
+/*
+    Search as you type over the tracks of a store, kept in step with it as
+    tracks are added, changed and deleted (it is a TrackStore::Listener).
+
+    Each track is indexed by the words of its title, its album and its artist
+    (the folder the file is in, and the folder that one is in, as libraries
+    are laid out). The words go in a vocabulary that is sorted, for prefixes,
+    and indexed by trigram, for the words a query word is inside of or is one
+    typo away from; every word has the tracks it is in. A query is looked up
+    in the vocabulary (tens of thousands of words at most), not the tracks,
+    so a keystroke takes well under a millisecond on 100,000 tracks.
+
+    Every word of a query has to match a track. The tracks are ranked by how
+    well: the whole word, then the start of a word, then inside a word, then
+    one typo away (two in long words); in the title counts twice as much as
+    in a folder name. Equally good tracks keep the order they were added in.
+
+    Message thread only, like the store.
+*/
+class SearchIndex : public TrackStore::Listener
+{
+public:
+    SearchIndex(TrackStore& _tracks);
+    ~SearchIndex() override;
+
+    //Tracks matching every word of the query, best first (the query is not case sensitive)
+    std::vector<TrackStore::TrackId> search(const std::string& query) const;
+
+    //Virtual pure functions from TrackStore::Listener (index the changes)
+    void trackAdded(TrackStore::TrackId id) override;
+    void trackChanged(TrackStore::TrackId id) override;
+    void trackRemoved(TrackStore::TrackId id) override;
+    void tracksCleared() override;
+
+    //Fields of a track (its title, album and artist), in the order they rank
+    enum Field
+    {
+        titleField = 0,
+        albumField,
+        artistField,
+        numFields
+    };
+
+    //Lower case words of a text, anything that is not a letter or a digit separates them
+    static std::vector<std::string> splitWords(const std::string& text);
+
+private:
+    //Index the fields of a track under a new slot
+    void addTrack(TrackStore::TrackId id);
+    void addWord(const std::string& word, int slot, Field field);
+    //Index every track of the store again (to drop the deleted ones)
+    void rebuild();
+
+    //Words of the vocabulary a query word matches, with how well
+    void matchWord(const std::string& queryWord, std::vector<std::pair<int, int>>& matches) const;
+    //Edit distance, or maxEdits + 1 when it is more than that
+    static int boundedEditDistance(const std::string& a, const std::string& b, int maxEdits);
+    static juce::uint32 trigramAt(const std::string& word, size_t at);
+
+    TrackStore& tracks;
+
+    //Slots of the tracks indexed, in the order they were added (a track changed or deleted leaves a dead one)
+    std::vector<TrackStore::TrackId> idOfSlot;
+    std::vector<juce::uint8> alive;
+    std::unordered_map<TrackStore::TrackId, int> slotOfId;
+    int numDead = 0;
+
+    //Vocabulary: the words, hashed, sorted for prefixes, by trigram, and the slot and field (slot * numFields + field) of every track each is in
+    std::vector<std::string> words;
+    std::unordered_map<std::string, int> wordIds;
+    std::map<std::string, int> sortedWordIds;
+    std::unordered_map<juce::uint32, std::vector<int>> wordsWithTrigram;
+    std::vector<std::vector<juce::uint32>> postings;
+
+    //Scratch space of a search, sized to the vocabulary and slots and cleared as it is used
+    mutable std::vector<int> trigramCounts;
+    mutable std::vector<int> wordScores;
+    struct SlotScore
+    {
+        int best = 0;
+        int total = 0;
+        int wordsMatched = 0;
+    };
+    mutable std::vector<SlotScore> slotScores;
+    mutable std::vector<juce::uint64> slotBits;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SearchIndex)
+};
@@ -0,0 +1,360 @@
+/*
+  ==============================================================================
+
+    TrackStore.cpp
+    Created: 4 Oct 2022 9:26:14am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "TrackStore.h"
+
+TrackStore::TrackStore()
+{
+}
+
+TrackStore::~TrackStore()
+{
+}
+
+void TrackStore::addListener(Listener* listener)
+{
+    listeners.add(listener);
+}
+
+void TrackStore::removeListener(Listener* listener)
+{
+    listeners.remove(listener);
+}
+
+//==============================================================================
+TrackStore::TrackId TrackStore::add(const TrackInfo& track)
+{
+    auto id = append(track);
+    if (id != invalidId)
+    {
+        changed();
+    }
+    return id;
+}
+
+std::vector<TrackStore::TrackId> TrackStore::addBatch(const std::vector<TrackInfo>& newTracks)
+{
+    //Room for all of them at once, a single notification for the lot
+    auto size = ids.size() + newTracks.size();
+    ids.reserve(size);
+    files.reserve(size);
+    urls.reserve(size);
+    titles.reserve(size);
+    lengths.reserve(size);
+    sampleRates.reserve(size);
+    fileSizes.reserve(size);
+    modificationTimes.reserve(size);
+    contentHashes.reserve(size);
+    alive.reserve(size);
+    slotOfId.reserve(slotOfId.size() + newTracks.size());
+    idOfPath.reserve(idOfPath.size() + newTracks.size());
+
+    std::vector<TrackId> newIds;
+    newIds.reserve(newTracks.size());
+    bool anyAdded = false;
+    for (const auto& track : newTracks)
+    {
+        newIds.push_back(append(track));
+        anyAdded = anyAdded || newIds.back() != invalidId;
+    }
+
+    if (anyAdded)
+    {
+        changed();
+    }
+    return newIds;
+}
+
+TrackStore::TrackId TrackStore::append(const TrackInfo& track)
+{
+    //Check if the file is already in the store (found again by a scan, or added twice)
+    auto path = track.file.getFullPathName().toStdString();
+    if (idOfPath.count(path) != 0)
+    {
+        return invalidId;
+    }
+
+    auto id = nextId++;
+    int slot = (int) ids.size();
+    ids.push_back(id);
+    files.push_back(track.file);
+    urls.push_back(track.url);
+    titles.push_back(track.title);
+    lengths.push_back(track.lengthInSeconds);
+    sampleRates.push_back(track.sampleRate);
+    fileSizes.push_back(track.fileSize);
+    modificationTimes.push_back(track.modificationTime);
+    contentHashes.push_back(track.contentHash);
+    alive.push_back(true);
+
+    slotOfId[id] = slot;
+    idOfPath[path] = id;
+    //Out of date from now on, in case a listener reads the rows
+    rowsOutOfDate = true;
+
+    listeners.call([id](Listener& l) { l.trackAdded(id); });
+    return id;
+}
+
+bool TrackStore::update(TrackId id, const TrackInfo& track)
+{
+    int slot = getSlot(id);
+    if (slot < 0)
+    {
+        return false;
+    }
+    auto s = (size_t) slot;
+
+    auto oldPath = files[s].getFullPathName().toStdString();
+    auto path = idOfPath.find(oldPath);
+    if (path != idOfPath.end() && path->second == id)
+    {
+        idOfPath.erase(path);
+    }
+    idOfPath[track.file.getFullPathName().toStdString()] = id;
+
+    files[s] = track.file;
+    urls[s] = track.url;
+    titles[s] = track.title;
+    lengths[s] = track.lengthInSeconds;
+    sampleRates[s] = track.sampleRate;
+    fileSizes[s] = track.fileSize;
+    modificationTimes[s] = track.modificationTime;
+    contentHashes[s] = track.contentHash;
+
+    listeners.call([id](Listener& l) { l.trackChanged(id); });
+    changed();
+    return true;
+}
+
+bool TrackStore::remove(TrackId id)
+{
+    int slot = getSlot(id);
+    if (slot < 0)
+    {
+        return false;
+    }
+
+    listeners.call([id](Listener& l) { l.trackRemoved(id); });
+
+    //Only marked dead here, the columns are compacted once enough tracks are
+    alive[(size_t) slot] = false;
+    ++numDead;
+    slotOfId.erase(id);
+    auto path = idOfPath.find(files[(size_t) slot].getFullPathName().toStdString());
+    if (path != idOfPath.end() && path->second == id)
+    {
+        idOfPath.erase(path);
+    }
+
+    if (numDead > 1024 && numDead * 2 > (int) ids.size())
+    {
+        compact();
+    }
+    changed();
+    return true;
+}
+
+void TrackStore::clear()
+{
+    //IDs go on from where they were, so old ones never come back
+    ids.clear();
+    files.clear();
+    urls.clear();
+    titles.clear();
+    lengths.clear();
+    sampleRates.clear();
+    fileSizes.clear();
+    modificationTimes.clear();
+    contentHashes.clear();
+    alive.clear();
+    numDead = 0;
+    slotOfId.clear();
+    idOfPath.clear();
+
+    listeners.call([](Listener& l) { l.tracksCleared(); });
+    changed();
+}
+
+void TrackStore::compact()
+{
+    OTODESKS_PROFILE_SCOPE("TrackStore::compact");
+
+    size_t live = 0;
+    for (size_t slot = 0; slot < ids.size(); ++slot)
+    {
+        if (!alive[slot])
+        {
+            continue;
+        }
+
+        if (live != slot)
+        {
+            ids[live] = ids[slot];
+            files[live] = std::move(files[slot]);
+            urls[live] = std::move(urls[slot]);
+            titles[live] = std::move(titles[slot]);
+            lengths[live] = lengths[slot];
+            sampleRates[live] = sampleRates[slot];
+            fileSizes[live] = fileSizes[slot];
+            modificationTimes[live] = modificationTimes[slot];
+            contentHashes[live] = contentHashes[slot];
+            alive[live] = true;
+            slotOfId[ids[live]] = (int) live;
+        }
+        ++live;
+    }
+
+    ids.resize(live);
+    files.resize(live);
+    urls.resize(live);
+    titles.resize(live);
+    lengths.resize(live);
+    sampleRates.resize(live);
+    fileSizes.resize(live);
+    modificationTimes.resize(live);
+    contentHashes.resize(live);
+    alive.resize(live);
+    numDead = 0;
+}
+
+void TrackStore::changed()
+{
+    rowsOutOfDate = true;
+    //Asynchronous, so any number of changes in a row is a single message
+    sendChangeMessage();
+}
+
+//==============================================================================
+int TrackStore::getNumRows() const
+{
+    updateRows();
+    return (int) rows.size();
+}
+
+TrackStore::TrackId TrackStore::getIdAtRow(int row) const
+{
+    updateRows();
+    return juce::isPositiveAndBelow(row, (int) rows.size()) ? ids[(size_t) rows[(size_t) row]] : invalidId;
+}
+
+int TrackStore::getRowOf(TrackId id) const
+{
+    int slot = getSlot(id);
+    if (slot < 0)
+    {
+        return -1;
+    }
+    updateRows();
+    return rowOfSlot[(size_t) slot];
+}
+
+void TrackStore::updateRows() const
+{
+    if (!rowsOutOfDate)
+    {
+        return;
+    }
+
+    rows.clear();
+    rows.reserve(ids.size() - (size_t) numDead);
+    rowOfSlot.assign(ids.size(), -1);
+    for (size_t slot = 0; slot < ids.size(); ++slot)
+    {
+        if (alive[slot])
+        {
+            rowOfSlot[slot] = (int) rows.size();
+            rows.push_back((int) slot);
+        }
+    }
+    rowsOutOfDate = false;
+}
+
+//==============================================================================
+TrackStore::TrackId TrackStore::findByFile(const juce::File& file) const
+{
+    auto it = idOfPath.find(file.getFullPathName().toStdString());
+    return it != idOfPath.end() ? it->second : invalidId;
+}
+
+bool TrackStore::contains(TrackId id) const
+{
+    return getSlot(id) >= 0;
+}
+
+int TrackStore::getSlot(TrackId id) const
+{
+    auto it = slotOfId.find(id);
+    return it != slotOfId.end() ? it->second : -1;
+}
+
+const juce::File& TrackStore::getFile(TrackId id) const
+{
+    jassert(contains(id));
+    return files[(size_t) getSlot(id)];
+}
+
+const juce::URL& TrackStore::getURL(TrackId id) const
+{
+    jassert(contains(id));
+    return urls[(size_t) getSlot(id)];
+}
+
+const std::string& TrackStore::getTitle(TrackId id) const
+{
+    jassert(contains(id));
+    return titles[(size_t) getSlot(id)];
+}
+
+double TrackStore::getLengthInSeconds(TrackId id) const
+{
+    jassert(contains(id));
+    return lengths[(size_t) getSlot(id)];
+}
+
+double TrackStore::getSampleRate(TrackId id) const
+{
+    jassert(contains(id));
+    return sampleRates[(size_t) getSlot(id)];
+}
+
+juce::int64 TrackStore::getFileSize(TrackId id) const
+{
+    jassert(contains(id));
+    return fileSizes[(size_t) getSlot(id)];
+}
+
+juce::int64 TrackStore::getModificationTime(TrackId id) const
+{
+    jassert(contains(id));
+    return modificationTimes[(size_t) getSlot(id)];
+}
+
+juce::uint64 TrackStore::getContentHash(TrackId id) const
+{
+    jassert(contains(id));
+    return contentHashes[(size_t) getSlot(id)];
+}
+
+TrackStore::TrackInfo TrackStore::getInfo(TrackId id) const
+{
+    jassert(contains(id));
+    auto slot = (size_t) getSlot(id);
+    return { files[slot], urls[slot], titles[slot], lengths[slot], sampleRates[slot], fileSizes[slot], modificationTimes[slot], contentHashes[slot] };
+}
+
+std::string TrackStore::formatDuration(double lengthInSeconds)
+{
+    //Convert length into hr:min:sec
+    double hour = trunc(lengthInSeconds / 3600);
+    double min = trunc((lengthInSeconds - (hour * 3600)) / 60);
+    double sec = trunc(lengthInSeconds - (hour * 3600) - (min * 60));
+    return std::to_string((int)hour) + ":" + std::to_string((int)min) + ":" + std::to_string((int)sec);
+}
@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    TrackStore.h
+    Created: 4 Oct 2022 9:26:14am
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../Engine/AudioProfiler.h"
+
+//==============================================================================
+/*
+    The tracks of the library, a column per field. Every track gets an ID when
+    it is added that stays the same whatever is added or deleted around it
+    (IDs are never reused), so the table, its delete buttons and the decks can
+    hold on to it instead of a row number.
+
+    Tracks are found by ID or file through hash maps, a file is in the store
+    once (tracks of the same title in different folders are all kept). Deleting only
+    marks the track dead; the rows are rebuilt the next time they are read and
+    the dead tracks are dropped from the columns once they are half of them,
+    so any number of deletes costs a single pass. Listeners (change messages)
+    hear once for any number of changes made in a row, a batch of 100,000
+    tracks included; a TrackStore::Listener hears of every track straight
+    away, to keep an index of its own in step.
+
+    Message thread only.
+*/
+class TrackStore : public juce::ChangeBroadcaster
+{
+public:
+    using TrackId = juce::uint32;
+    static constexpr TrackId invalidId = 0;
+
+    //What is known of a track when it is added
+    struct TrackInfo
+    {
+        juce::File file;
+        juce::URL url;
+        std::string title;
+        double lengthInSeconds = 0;
+        double sampleRate = 0;
+        //Fingerprint of the file when it was probed, to tell whether it has changed since (or has been moved)
+        juce::int64 fileSize = 0;
+        juce::int64 modificationTime = 0;
+        juce::uint64 contentHash = 0;
+    };
+
+    //Hears of every change as it is made (unlike change messages), to keep an index of the tracks
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        virtual void trackAdded(TrackId id) = 0;
+        //Fields of the track have been changed, its ID and row are the same
+        virtual void trackChanged(TrackId id) = 0;
+        //Called before the track is gone, its fields can still be read
+        virtual void trackRemoved(TrackId id) = 0;
+        virtual void tracksCleared() = 0;
+    };
+
+    TrackStore();
+    ~TrackStore() override;
+
+    void addListener(Listener* listener);
+    void removeListener(Listener* listener);
+
+    //Add a track, returns its ID, or invalidId if its file is in the store already
+    TrackId add(const TrackInfo& track);
+    //Add tracks (in order), returns their IDs (invalidId for the ones left out)
+    std::vector<TrackId> addBatch(const std::vector<TrackInfo>& newTracks);
+    //Change the fields of a track, keeping its ID and row, returns false if there is no such track
+    bool update(TrackId id, const TrackInfo& track);
+    //Delete a track, returns false if there is no such track
+    bool remove(TrackId id);
+    void clear();
+
+    //Tracks in the order they were added, deleted ones left out
+    int getNumRows() const;
+    TrackId getIdAtRow(int row) const;
+    //Row of a track, -1 if there is no such track
+    int getRowOf(TrackId id) const;
+
+    //Look up by file, invalidId when not found
+    TrackId findByFile(const juce::File& file) const;
+    bool contains(TrackId id) const;
+
+    //Fields of a track (the track must be in the store)
+    const juce::File& getFile(TrackId id) const;
+    const juce::URL& getURL(TrackId id) const;
+    const std::string& getTitle(TrackId id) const;
+    double getLengthInSeconds(TrackId id) const;
+    double getSampleRate(TrackId id) const;
+    juce::int64 getFileSize(TrackId id) const;
+    juce::int64 getModificationTime(TrackId id) const;
+    juce::uint64 getContentHash(TrackId id) const;
+    //All the fields of a track together
+    TrackInfo getInfo(TrackId id) const;
+
+    //Length as hr:min:sec, as the table shows it
+    static std::string formatDuration(double lengthInSeconds);
+
+private:
+    //Append a track to the columns, no notification
+    TrackId append(const TrackInfo& track);
+    int getSlot(TrackId id) const;
+    //Rebuild the rows from the live slots when they are out of date
+    void updateRows() const;
+    //Drop the dead slots from the columns
+    void compact();
+    void changed();
+
+    //Columns, a slot per track added since the last compaction
+    std::vector<TrackId> ids;
+    std::vector<juce::File> files;
+    std::vector<juce::URL> urls;
+    std::vector<std::string> titles;
+    std::vector<double> lengths;
+    std::vector<double> sampleRates;
+    std::vector<juce::int64> fileSizes;
+    std::vector<juce::int64> modificationTimes;
+    std::vector<juce::uint64> contentHashes;
+    std::vector<bool> alive;
+    int numDead = 0;
+
+    //Hashed lookups (live tracks only)
+    std::unordered_map<TrackId, int> slotOfId;
+    std::unordered_map<std::string, TrackId> idOfPath;
+
+    //Live slots in order, and the row of every slot (-1 for dead ones), rebuilt when read after a change
+    mutable std::vector<int> rows;
+    mutable std::vector<int> rowOfSlot;
+    mutable bool rowsOutOfDate = false;
+
+    TrackId nextId = 1;
+
+    juce::ListenerList<Listener> listeners;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackStore)
+};
@@ -1,198 +1,263 @@
-/*
-  ==============================================================================
-
-    LibraryControl.cpp
-    Created: 21 Aug 2022 1:52:03pm
-    Author:  Api Rich
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "LibraryControl.h"
-
-//==============================================================================
-LibraryControl::LibraryControl(PlaylistComponent* _playList, 
-                               juce::AudioFormatManager& _formatManager) : playList(_playList),
-                                                                           formatManager(_formatManager)
-{
-    //Set image for the upload track button
-    //and make it visible
-    juce::Image importImage = juce::ImageCache::getFromMemory(BinaryData::import_png, BinaryData::import_pngSize);
-    importButton.setImages(false, true, true, importImage, 1.0f, {}, importImage, 1.0f, {}, importImage, 1.0f, {});
-    addAndMakeVisible(importButton);
-    //Make buttons and the search field visible on the GUI layout
-    addAndMakeVisible(saveButton);
-    addAndMakeVisible(loadButton);
-    addAndMakeVisible(searchInput);   
-
-    //Register listener to all buttons and the search field
-    importButton.addListener(this);
-    saveButton.addListener(this);
-    loadButton.addListener(this);
-    searchInput.addListener(this);
-
-    //Make the search field editable
-    searchInput.setEditable(true);
-    //Set the search field prompt text
-    searchInput.setText("Search Track", juce::NotificationType::dontSendNotification);
-
-    //Set LookandFeel for buttons and the search field
-    saveButton.setLookAndFeel(&customAllButton);
-    loadButton.setLookAndFeel(&customAllButton);
-    searchInput.setLookAndFeel(&customAllButton);
-}
-
-LibraryControl::~LibraryControl()
-{
-    
-}
-
-void LibraryControl::paint (juce::Graphics& g)
-{
-    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
-
-    //Set background color of the whole LibraryControl component
-    g.fillAll(juce::Colours::darkslategrey);
-    //Set text color
-    g.setColour (juce::Colours::white);
-    //Set font size
-    g.setFont (14.0f);
-
-    //Set color for searchInput field
-    searchInput.setColour(juce::Label::backgroundColourId, juce::Colours::darkred);  
-}
-
-void LibraryControl::resized()
-{
-    //Set the sizes of all button and the search field
-    importButton.setBounds( - getHeight() / 2.5, - getHeight() / 2.5, 1.8 * getHeight(), 1.8 * getHeight());
-    saveButton.setBounds(getWidth() / 12, getHeight() / 3, getWidth() / 6, getHeight() / 2);
-    loadButton.setBounds(5 * getWidth() / 18, getHeight() / 3, getWidth() / 6, getHeight() / 2);
-    searchInput.setBounds(17 * getWidth() / 36, getHeight() / 3, getWidth() / 2, getHeight() / 2);
-}
-
-void LibraryControl::buttonClicked(juce::Button* button)
-{
-    //Upload track button event
-    if (button == &importButton)
-    {
-        //Create & open a file chooser to load a file
-        juce::FileChooser chooser{ "Select a file..." };
-        if (chooser.browseForFileToOpen())
-        {
-            //Get the URL of the chosen track
-            juce::URL fileURL = chooser.getURLResult() ;
-            //Check if it is in audio format
-            auto* reader = formatManager.createReaderFor(fileURL.createInputStream(false));
-
-            if (reader != nullptr)  //Good file
-            {
-                //Get the file of the chosen track
-                juce::File trackFile = chooser.getResult();
-
-                //Get the name of the chosen track
-                std::string fileName = chooser.getResult().getFileNameWithoutExtension().toStdString();
-                //Get the length (in second) of the chosen track
-                double lengthInSeconds = reader->lengthInSamples / reader->sampleRate;
-                //Add the chosen track to the table list library
-                playList->addNewTrack(trackFile, fileName, fileURL, lengthInSeconds);
-            }
-        }
-    }
-
-    //Save library button event
-    if (button == &saveButton)
-    {
-        //Create & open a file chooser to save
-        juce::FileChooser fcsl{ "Save Library",
-                     juce::File::getCurrentWorkingDirectory().getChildFile(""),
-                     "",
-                     true };
-
-        if (fcsl.browseForFileToSave(true))
-        {
-            //Create a temporary file in the directory where the file chooser was last chosen
-            juce::File tempFile = fcsl.getResult();
-            //Create a directory for the temporary file
-            tempFile.createDirectory();
-            //Sent the directory to saveLibrary() (in PlaylistComponent.cpp)
-            //for all the current files on the table list library to be copied to the directory
-            playList->saveLibrary(tempFile);
-        }
-    }
-
-    //Load library button event
-    if (button == &loadButton)
-    {
-        //Create & open a file chooser to load a directory
-        juce::FileChooser fcll{ "Load Library",
-                    juce::File::getCurrentWorkingDirectory().getChildFile(""),
-                    "",
-                    true };
-
-        if (fcll.browseForDirectory())
-        {
-            //Call loadLibrary() (in PlaylistComponent.cpp) to clear data on the current table list library
-            playList->loadLibrary();
-
-            //Store all files from the chosen directory
-            juce::Array<juce::File> libDirFiles = fcll.getResult().findChildFiles(juce::File::findFiles, false);
-
-            //Looping through all the files to get it data and add them to the table list library
-            for (int i = 0; i < libDirFiles.size(); ++i)
-            {
-                //Get URLs of the files
-                juce::URL libDirFileURL(libDirFiles.operator[](i));
-                
-                //Check if it is in audio format (in case the library was adjusted outside the Otodesks app)
-                auto* reader = formatManager.createReaderFor(libDirFileURL.createInputStream(false));
-
-                if (reader != nullptr)  //Good file
-                {
-                    juce::File trackFile = libDirFiles.operator[](i);                
-                    std::string fileName = libDirFiles.operator[](i).getFileNameWithoutExtension().toStdString();
-                    double lengthInSeconds = reader->lengthInSamples / reader->sampleRate;
-                    playList->addNewTrack(trackFile, fileName, libDirFileURL, lengthInSeconds);
-                }       
-            }
-        }
-    }
-}
-
-void LibraryControl::labelTextChanged(juce::Label* labelThatHasChanged)
-{
-    //Search field event
-    if (labelThatHasChanged = &searchInput)
-    {     
-        //Check if currently there is on the table list library
-        searchTracks = playList->searchLibrary();
-        if (searchTracks.empty())   //No
-        {
-            searchInput.setText("Library has no track!", juce::NotificationType::dontSendNotification);
-        }
-        else   //Yes
-        {
-            //Get the name of the search track
-            std::string searchVal = searchInput.getText().toStdString();
-
-            //Looping through all the tracks on the table list library
-            for (int i = 0; i < searchTracks.size(); ++i)
-            {
-                if (searchVal == searchTracks[i])   //The search track is currently on the table list library
-                {
-                    searchInput.setText(searchVal, juce::NotificationType::dontSendNotification);
-                    playList->chooseRow(i);
-                    std::cout << "match" << searchTracks.size() << std::endl;
-                    break;                          
-                }
-                else   //The search track is currently not on the table list library              
-                {
-                    searchInput.setText("No track found!", juce::NotificationType::dontSendNotification);
-                    std::cout << "no match" << searchTracks.size() << std::endl;
-                }
-            }
-        }
-    }
-}
-
+/*
+  ==============================================================================
+
+    LibraryControl.cpp
+    Created: 21 Aug 2022 1:52:03pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "LibraryControl.h"
+
+//==============================================================================
+LibraryControl::LibraryControl(PlaylistComponent* _playList, 
+                               juce::AudioFormatManager& _formatManager) : playList(_playList),
+                                                                           formatManager(_formatManager)
+{
+    //Set image for the upload track button
+    //and make it visible
+    juce::Image importImage = juce::ImageCache::getFromMemory(BinaryData::import_png, BinaryData::import_pngSize);
+    importButton.setImages(false, true, true, importImage, 1.0f, {}, importImage, 1.0f, {}, importImage, 1.0f, {});
+    addAndMakeVisible(importButton);
+    //Make buttons and the search field visible on the GUI layout
+    addAndMakeVisible(saveButton);
+    addAndMakeVisible(loadButton);
+    addAndMakeVisible(searchInput);   
+
+    //Register listener to all buttons and the search field
+    importButton.addListener(this);
+    saveButton.addListener(this);
+    loadButton.addListener(this);
+    searchInput.addListener(this);
+
+    //Make the search field editable
+    searchInput.setEditable(true);
+    //Set the search field prompt text
+    searchInput.setText("Search Track", juce::NotificationType::dontSendNotification);
+
+    //Set LookandFeel for buttons and the search field
+    saveButton.setLookAndFeel(&customAllButton);
+    loadButton.setLookAndFeel(&customAllButton);
+    searchInput.setLookAndFeel(&customAllButton);
+
+    //Tracks found by the library scanner go on the table list library in batches, the load button shows the progress
+    scanner.onTracksFound = [this](const std::vector<TrackStore::TrackInfo>& tracks)
+    {
+        playList->addNewTracks(tracks);
+    };
+    scanner.onProgress = [this](int filesDone, int filesFound, bool finished)
+    {
+        loadButton.setButtonText(finished ? juce::String("LOAD LIBRARY")
+                                          : "CANCEL " + juce::String(filesDone) + "/" + juce::String(filesFound));
+    };
+
+    //Files added or changed in the library folders since, or while the app runs, are probed again (only them)
+    watcher.onTracksAdded = [this](const std::vector<TrackStore::TrackInfo>& tracks)
+    {
+        playList->addNewTracks(tracks);
+    };
+    watcher.onTracksModified = [this](const std::vector<TrackStore::TrackInfo>& tracks)
+    {
+        playList->reindexTracks(tracks);
+    };
+    watcher.watch(playList->getLibraryRoots(), true);
+
+    //Consolidating a saved library shows its progress and throughput on the save button
+    exporter.onProgress = [this](const LibraryExporter::Progress& progress)
+    {
+        if (progress.finished)
+        {
+            saveButton.setButtonText("SAVE LIBRARY");
+            //The saved library still references the tracks that could not be put in its folder, where they are
+            if (progress.filesFailed > 0)
+            {
+                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                                                       "Save Library",
+                                                       juce::String(progress.filesFailed) + " of " + juce::String(progress.numFiles)
+                                                           + " tracks could not be put in the folder, the library references them where they are.");
+            }
+            return;
+        }
+
+        auto percent = progress.numBytes > 0 ? (int) (100 * progress.bytesDone / progress.numBytes) : 100;
+        auto megabytesPerSecond = progress.bytesPerSecond / (1024 * 1024);
+        saveButton.setButtonText("CANCEL " + juce::String(percent) + "% " + juce::String(megabytesPerSecond, 1) + " MB/s");
+    };
+}
+
+LibraryControl::~LibraryControl()
+{
+    
+}
+
+void LibraryControl::paint (juce::Graphics& g)
+{
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
+
+    //Set background color of the whole LibraryControl component
+    g.fillAll(juce::Colours::darkslategrey);
+    //Set text color
+    g.setColour (juce::Colours::white);
+    //Set font size
+    g.setFont (14.0f);
+
+    //Set color for searchInput field
+    searchInput.setColour(juce::Label::backgroundColourId, juce::Colours::darkred);  
+}
+
+void LibraryControl::resized()
+{
+    //Set the sizes of all button and the search field
+    importButton.setBounds( - getHeight() / 2.5, - getHeight() / 2.5, 1.8 * getHeight(), 1.8 * getHeight());
+    saveButton.setBounds(getWidth() / 12, getHeight() / 3, getWidth() / 6, getHeight() / 2);
+    loadButton.setBounds(5 * getWidth() / 18, getHeight() / 3, getWidth() / 6, getHeight() / 2);
+    searchInput.setBounds(17 * getWidth() / 36, getHeight() / 3, getWidth() / 2, getHeight() / 2);
+}
+
+void LibraryControl::buttonClicked(juce::Button* button)
+{
+    //Upload track button event
+    if (button == &importButton)
+    {
+        //Create & open a file chooser to load a file
+        juce::FileChooser chooser{ "Select a file..." };
+        if (chooser.browseForFileToOpen())
+        {
+            //Check if it is in audio format, and get its name and length
+            TrackStore::TrackInfo track;
+            if (LibraryIndex::probe(formatManager, chooser.getResult(), track))  //Good file
+            {
+                //Add the chosen track to the table list library
+                playList->addNewTrack(track);
+            }
+        }
+    }
+
+    //Save library button event (it cancels consolidating while the tracks are being put in a saved library)
+    if (button == &saveButton)
+    {
+        if (exporter.isExporting())
+        {
+            exporter.cancel();
+            saveButton.setButtonText("SAVE LIBRARY");
+            return;
+        }
+
+        //Create & open a file chooser to save
+        juce::FileChooser fcsl{ "Save Library",
+                     juce::File::getCurrentWorkingDirectory().getChildFile(""),
+                     "",
+                     true };
+
+        if (fcsl.browseForFileToSave(true))
+        {
+            //Create a temporary file in the directory where the file chooser was last chosen
+            juce::File tempFile = fcsl.getResult();
+            //Create a directory for the temporary file
+            tempFile.createDirectory();
+            //Sent the directory to saveLibrary() (in PlaylistComponent.cpp)
+            //for a playlist and an index referencing the current tracks on the table list library to be written there
+            playList->saveLibrary(tempFile);
+
+            //Optionally put the tracks themselves in the directory too, in the background
+            if (juce::AlertWindow::showOkCancelBox(juce::AlertWindow::QuestionIcon,
+                                                   "Save Library",
+                                                   "The library has been saved referencing the tracks where they are.\n"
+                                                   "Consolidate it: put the tracks in the folder as well?",
+                                                   "Consolidate",
+                                                   "Done",
+                                                   this))
+            {
+                exporter.startConsolidating(tempFile, playList->getLibraryTracks());
+                saveButton.setButtonText("CANCEL");
+            }
+        }
+    }
+
+    //Load library button event (it cancels the scan while a library is being loaded)
+    if (button == &loadButton)
+    {
+        if (scanner.isScanning())
+        {
+            scanner.cancel();
+            loadButton.setButtonText("LOAD LIBRARY");
+            return;
+        }
+
+        //Create & open a file chooser to load a directory
+        juce::FileChooser fcll{ "Load Library",
+                    juce::File::getCurrentWorkingDirectory().getChildFile(""),
+                    "",
+                    true };
+
+        if (fcll.browseForDirectory())
+        {
+            //Call loadLibrary() (in PlaylistComponent.cpp) to clear data on the current table list library
+            playList->loadLibrary();
+
+            //Scan the chosen directory and the ones in it in the background, tracks are added as they are found
+            scanner.start(fcll.getResult());
+            //and watch it from now on, with the folders of the tracks a saved library references
+            std::vector<juce::File> roots{ fcll.getResult() };
+            LibraryIndex index;
+            if (index.load(fcll.getResult().getChildFile(LibraryIndex::indexFileName)))
+            {
+                for (const auto& root : index.getRoots())
+                {
+                    if (root != roots.front() && !root.isAChildOf(roots.front()))
+                    {
+                        roots.push_back(root);
+                    }
+                }
+            }
+            playList->setLibraryRoots(roots);
+            watcher.watch(roots, false);
+            loadButton.setButtonText("CANCEL");
+        }
+    }
+}
+
+void LibraryControl::labelTextChanged(juce::Label* labelThatHasChanged)
+{
+    //Search field event (when the search is entered, the table list library is filtered as it is typed, see editorShown)
+    if (labelThatHasChanged == &searchInput)
+    {     
+        searchText = searchInput.getText().toStdString();
+        int numFound = playList->filterLibrary(searchText);
+
+        //Check if currently there is on the table list library
+        if (playList->getTrackStore().getNumRows() == 0)   //No
+        {
+            searchInput.setText("Library has no track!", juce::NotificationType::dontSendNotification);
+        }
+        else if (SearchIndex::splitWords(searchText).empty())   //Nothing to search, all the tracks are shown
+        {
+            searchInput.setText("Search Track", juce::NotificationType::dontSendNotification);
+        }
+        else if (numFound > 0)   //Tracks found, the best match is selected
+        {
+            playList->chooseRow(0);
+            std::cout << "LibraryControl::labelTextChanged " << numFound << " found" << std::endl;
+        }
+        else   //The search track is currently not on the table list library
+        {
+            searchInput.setText("No track found!", juce::NotificationType::dontSendNotification);
+            std::cout << "no match" << std::endl;
+        }
+    }
+}
+
+void LibraryControl::editorShown(juce::Label* label, juce::TextEditor& editor)
+{
+    if (label == &searchInput)
+    {
+        //Edit the search itself, not the prompt or a message, and filter the table list library at every keystroke
+        editor.setText(searchText, false);
+        editor.onTextChange = [this, &editor]
+        {
+            playList->filterLibrary(editor.getText().toStdString());
+        };
+    }
+}
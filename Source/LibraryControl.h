@@ -1,63 +1,73 @@
-/*
-  ==============================================================================
-
-    LibraryControl.h
-    Created: 21 Aug 2022 1:52:03pm
-    Author:  Api Rich
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include <string>
-#include "PlaylistComponent.h"
-
-#include "CustomLookAndFeel.h"
-
-//==============================================================================
-/*
-*/
-class LibraryControl  : public juce::Component,
-                        public juce::Button::Listener,
-                        public juce::Label::Listener
-{
-public:
-    LibraryControl(PlaylistComponent* _playList, juce::AudioFormatManager& _formatManager);
-    ~LibraryControl() override;
-
-    void paint (juce::Graphics&) override;
-    void resized() override;
-
-    //Virtual pure functions from Button::Listener
-    void buttonClicked(juce::Button*) override;
-
-    //Virtual pure functions from Label::Listener
-    void labelTextChanged(juce::Label* labelThatHasChanged) override;
-
-
-private:
-    //Upload track button
-    juce::ImageButton importButton{ "IMPORT" };
-    //Save Library button
-    juce::TextButton saveButton{ "SAVE LIBRARY" };
-    //Load Library button
-    juce::TextButton loadButton{ "LOAD LIBRARY" };
-
-    //Table list library reference (from PlaylistComponent.cpp)
-    PlaylistComponent* playList;
-
-    //Audio format manager reference (from MainComponent.cpp)
-    juce::AudioFormatManager& formatManager;
-
-    //Search field
-    juce::Label searchInput;
-
-    //Store current tracks that are on the table list library (from PlaylistComponent.cpp)
-    std::vector<std::string> searchTracks;
-
-    //LookAndFeel (custom graphic) for buttons and the search field
-    CustomLookAndFeel customAllButton;
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryControl)
-};
+/*
+  ==============================================================================
+
+    LibraryControl.h
+    Created: 21 Aug 2022 1:52:03pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <string>
+#include "PlaylistComponent.h"
+#include "Library/LibraryScanner.h"
+#include "Library/LibraryWatcher.h"
+#include "Library/LibraryExporter.h"
+
+#include "CustomLookAndFeel.h"
+
+//==============================================================================
+/*
+*/
+class LibraryControl  : public juce::Component,
+                        public juce::Button::Listener,
+                        public juce::Label::Listener
+{
+public:
+    LibraryControl(PlaylistComponent* _playList, juce::AudioFormatManager& _formatManager);
+    ~LibraryControl() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    //Virtual pure functions from Button::Listener
+    void buttonClicked(juce::Button*) override;
+
+    //Virtual pure functions from Label::Listener
+    void labelTextChanged(juce::Label* labelThatHasChanged) override;
+    //Override function from Label::Listener (search as it is typed)
+    void editorShown(juce::Label* label, juce::TextEditor& editor) override;
+
+
+private:
+    //Upload track button
+    juce::ImageButton importButton{ "IMPORT" };
+    //Save Library button
+    juce::TextButton saveButton{ "SAVE LIBRARY" };
+    //Load Library button
+    juce::TextButton loadButton{ "LOAD LIBRARY" };
+
+    //Table list library reference (from PlaylistComponent.cpp)
+    PlaylistComponent* playList;
+
+    //Audio format manager reference (from MainComponent.cpp)
+    juce::AudioFormatManager& formatManager;
+
+    //Scans the folder of Load Library on background threads
+    LibraryScanner scanner{ formatManager };
+    //Keeps the table list library in step with the folder it is loaded from
+    LibraryWatcher watcher{ formatManager, playList->getTrackStore() };
+    //Puts the tracks of a saved library in its folder on a background thread
+    LibraryExporter exporter;
+
+    //Search field, and the search in it (it shows the prompt or a message otherwise)
+    juce::Label searchInput;
+    std::string searchText;
+
+    //LookAndFeel (custom graphic) for buttons and the search field
+    CustomLookAndFeel customAllButton;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryControl)
+};
@@ -1,89 +1,315 @@
-#include "MainComponent.h"
-
-//==============================================================================
-MainComponent::MainComponent() 
-{
-    // Make sure you set the size of the component after
-    // you add any child components.
-    setSize (800, 600);
-
-    // Some platforms require permissions to open input channels so request that here
-    if (juce::RuntimePermissions::isRequired (juce::RuntimePermissions::recordAudio)
-        && ! juce::RuntimePermissions::isGranted (juce::RuntimePermissions::recordAudio))
-    {
-        juce::RuntimePermissions::request (juce::RuntimePermissions::recordAudio,
-                                           [&] (bool granted) { setAudioChannels (granted ? 2 : 0, 2); });
-    }
-    else
-    {
-        // Specify the number of input and output channels that we want to open
-        setAudioChannels (0, 2);
-    }
-
-    //Make all components visible on the GUI layout
-    addAndMakeVisible(deckGUI1);
-    addAndMakeVisible(deckGUI2);
-    addAndMakeVisible(libraryControl);
-    addAndMakeVisible(playlistComponent);
-
-    //Register the Audio format manager
-    formatManager.registerBasicFormats();
-}
-
-MainComponent::~MainComponent()
-{
-    // This shuts down the audio device and clears the audio source.
-    shutdownAudio();
-}
-
-//==============================================================================
-void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
-{
-    //Prepare both left and right audio player & the Mix source
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-
-    //Add both left and right audio player into the Mix source
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
-}
-
-void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
-{
-    mixerSource.getNextAudioBlock(bufferToFill);
-}
-
-
-void MainComponent::releaseResources()
-{
-    player1.releaseResources();
-    player2.releaseResources();
-    mixerSource.releaseResources();
-}
-
-//==============================================================================
-void MainComponent::paint (juce::Graphics& g)
-{
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    // You can add your drawing code here!
-    g.setColour(juce::Colours::mediumturquoise);
-    g.drawRect(getLocalBounds(), 1);   // draw an outline around the component
-}
-
-void MainComponent::resized()
-{
-    DBG("MainComponent::resized");
-
-    //Set the sizes of all components
-    deckGUI1.setBounds(0, 0, getWidth() / 2, 3 * getHeight() / 5);
-    deckGUI2.setBounds(getWidth() / 2, 0, getWidth() / 2, 3 * getHeight() / 5);
-    libraryControl.setBounds(0, 3 * getHeight() / 5, getWidth(), getHeight() / 10);
-    playlistComponent.setBounds(0, 7 * getHeight() / 10, getWidth(), 3 * getHeight() / 5);
-}
-
-
-
-
+#include "MainComponent.h"
+
+//==============================================================================
+MainComponent::MainComponent() 
+{
+    // Make sure you set the size of the component after
+    // you add any child components.
+    setSize (800, 650);
+
+    // Some platforms require permissions to open input channels so request that here
+    if (juce::RuntimePermissions::isRequired (juce::RuntimePermissions::recordAudio)
+        && ! juce::RuntimePermissions::isGranted (juce::RuntimePermissions::recordAudio))
+    {
+        juce::RuntimePermissions::request (juce::RuntimePermissions::recordAudio,
+                                           [&] (bool granted) { setAudioChannels (granted ? 2 : 0, 2); });
+    }
+    else
+    {
+        // Specify the number of input and output channels that we want to open
+        setAudioChannels (0, 2);
+    }
+
+    //Make all components visible on the GUI layout
+    deckViewport.setViewedComponent(&deckHolder, false);
+    deckViewport.setScrollBarsShown(false, true);
+    deckViewport.setScrollBarThickness(10);
+    addAndMakeVisible(deckViewport);
+    addDeckButton.addListener(this);
+    addAndMakeVisible(addDeckButton);
+    addSamplerButton.addListener(this);
+    addAndMakeVisible(addSamplerButton);
+    traceButton.addListener(this);
+    addAndMakeVisible(traceButton);
+    addAndMakeVisible(libraryControl);
+    addAndMakeVisible(playlistComponent);
+
+    //Crossfader (even decks on side A, odd decks on side B)
+    crossfaderSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    crossfaderSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    crossfaderSlider.setRange(0.0, 1.0);
+    crossfaderSlider.setValue(0.5);
+    crossfaderSlider.addListener(this);
+    addAndMakeVisible(crossfaderSlider);
+
+    crossfaderCurveBox.addItem("Smooth", DeckMixer::smoothCrossfader + 1);
+    crossfaderCurveBox.addItem("Linear", DeckMixer::linearCrossfader + 1);
+    crossfaderCurveBox.addItem("Cut", DeckMixer::cutCrossfader + 1);
+    crossfaderCurveBox.setSelectedId(DeckMixer::smoothCrossfader + 1, juce::NotificationType::dontSendNotification);
+    crossfaderCurveBox.addListener(this);
+    addAndMakeVisible(crossfaderCurveBox);
+
+    qualityBox.addItem("SRC Low", ResamplingKernel::lowQuality + 1);
+    qualityBox.addItem("SRC Medium", ResamplingKernel::mediumQuality + 1);
+    qualityBox.addItem("SRC High", ResamplingKernel::highQuality + 1);
+    qualityBox.setSelectedId(decks.getResamplingQuality() + 1, juce::NotificationType::dontSendNotification);
+    qualityBox.addListener(this);
+    addAndMakeVisible(qualityBox);
+
+    headroomLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(headroomLabel);
+
+    //Register the Audio format manager
+    formatManager.registerBasicFormats();
+
+    //Start the shared read-ahead thread and size the buffer of each deck (in samples of the file)
+    readAheadThread.startThread();
+    decks.setReadAheadSize(65536);
+
+    //Decks are rendered in parallel when there is more than one core to spare
+    mixer.setRenderPool(&renderPool);
+
+    //Start with the left and right decks
+    addDeck();
+    addDeck();
+
+    //Refresh the headroom meter
+    startTimer(100);
+
+    AudioProfiler::nameThread("Message");
+}
+
+MainComponent::~MainComponent()
+{
+    stopTimer();
+
+    // This shuts down the audio device and clears the audio source.
+    shutdownAudio();
+
+    AudioProfiler::stop();
+
+    readAheadThread.stopThread(1000);
+}
+
+//==============================================================================
+void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    //Prepare the mixer, which prepares the audio players of all decks
+    mixer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    deviceSampleRate = sampleRate;
+    lastCallbackTicks = 0;
+}
+
+void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    AudioProfiler::nameThread("Audio");
+    OTODESKS_PROFILE_SCOPE("MainComponent::getNextAudioBlock");
+
+    //A callback more than two blocks after the previous one means the device has run dry in between
+    auto now = juce::Time::getHighResolutionTicks();
+    if (lastCallbackTicks != 0
+        && now - lastCallbackTicks > 2 * juce::Time::secondsToHighResolutionTicks(bufferToFill.numSamples / deviceSampleRate))
+    {
+        AudioProfiler::mark("Late callback");
+    }
+    lastCallbackTicks = now;
+
+    mixer.getNextAudioBlock(bufferToFill);
+}
+
+
+void MainComponent::releaseResources()
+{
+    mixer.releaseResources();
+}
+
+//==============================================================================
+void MainComponent::paint (juce::Graphics& g)
+{
+    // (Our component is opaque, so we must completely fill the background with a solid colour)
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+
+    // You can add your drawing code here!
+    g.setColour(juce::Colours::mediumturquoise);
+    g.drawRect(getLocalBounds(), 1);   // draw an outline around the component
+}
+
+void MainComponent::resized()
+{
+    DBG("MainComponent::resized");
+
+    //Set the sizes of all components (two decks are in view, the scroll bar and the mixer strip take 50 pixels under them)
+    int deckHeight = 3 * (getHeight() - 50) / 5;
+    int deckWidth = getWidth() / 2;
+    //Samplers are half a deck wide, after the last deck
+    int samplerWidth = deckWidth / 2;
+    int samplersX = deckGUIs.size() * deckWidth;
+    deckViewport.setBounds(0, 0, getWidth(), deckHeight + 10);
+    deckHolder.setSize(juce::jmax(getWidth(), samplersX + samplerGUIs.size() * samplerWidth), deckHeight);
+    for (int i = 0; i < deckGUIs.size(); ++i)
+    {
+        deckGUIs[i]->setBounds(i * deckWidth, 0, deckWidth, deckHeight);
+    }
+    for (int i = 0; i < samplerGUIs.size(); ++i)
+    {
+        samplerGUIs[i]->setBounds(samplersX + i * samplerWidth, 0, samplerWidth, deckHeight);
+    }
+
+    int stripY = deckHeight + 10;
+    crossfaderCurveBox.setBounds(10, stripY + 8, 100, 24);
+    addDeckButton.setBounds(120, stripY + 8, 80, 24);
+    addSamplerButton.setBounds(205, stripY + 8, 90, 24);
+    traceButton.setBounds(300, stripY + 8, 60, 24);
+    qualityBox.setBounds(365, stripY + 8, 90, 24);
+    crossfaderSlider.setBounds(465, stripY + 5, getWidth() - 715, 30);
+    headroomLabel.setBounds(getWidth() - 240, stripY + 8, 230, 24);
+
+    libraryControl.setBounds(0, stripY + 40, getWidth(), (getHeight() - 50) / 10);
+    playlistComponent.setBounds(0, stripY + 40 + (getHeight() - 50) / 10, getWidth(), 3 * (getHeight() - 50) / 5);
+}
+
+void MainComponent::addDeck()
+{
+    auto side = decks.getNumDecks() % 2 == 0 ? DeckMixer::sideA : DeckMixer::sideB;
+    auto* player = decks.addDeck(side);
+    if (player == nullptr)
+    {
+        return;
+    }
+
+    auto* deckGUI = deckGUIs.add(new DeckGUI(player, waveformCache, &playlistComponent));
+    deckHolder.addAndMakeVisible(deckGUI);
+
+    //No room for more
+    addDeckButton.setEnabled(decks.getNumDecks() < DeckRegistry::maxDecks);
+
+    resized();
+}
+
+void MainComponent::addSampler()
+{
+    auto* player = decks.addSampler();
+    if (player == nullptr)
+    {
+        return;
+    }
+
+    auto* samplerGUI = samplerGUIs.add(new SamplerGUI(player, &playlistComponent));
+    deckHolder.addAndMakeVisible(samplerGUI);
+
+    //No room for more
+    addSamplerButton.setEnabled(decks.getNumSamplers() < DeckRegistry::maxSamplers);
+
+    resized();
+}
+
+void MainComponent::toggleTrace()
+{
+    if (!AudioProfiler::isRecording())
+    {
+        AudioProfiler::start();
+        traceButton.setButtonText("STOP");
+        traceButton.setColour(juce::TextButton::buttonColourId, juce::Colours::darkred);
+        return;
+    }
+
+    AudioProfiler::stop();
+    traceButton.setButtonText("TRACE");
+    traceButton.removeColour(juce::TextButton::buttonColourId);
+
+    juce::FileChooser chooser{ "Save Trace",
+                               juce::File::getCurrentWorkingDirectory().getChildFile("otodesks-trace.json"),
+                               "*.json",
+                               true };
+    if (chooser.browseForFileToSave(true))
+    {
+        AudioProfiler::exportTrace(chooser.getResult());
+    }
+}
+
+void MainComponent::buttonClicked(juce::Button* button)
+{
+    //Add deck button event
+    if (button == &addDeckButton)
+    {
+        addDeck();
+        //Show the new deck (the samplers come after it)
+        deckViewport.setViewPosition(juce::jmax(0, deckGUIs.getLast()->getRight() - deckViewport.getWidth()), 0);
+    }
+
+    //Add sampler button event
+    if (button == &addSamplerButton)
+    {
+        addSampler();
+        //Show the new sampler
+        deckViewport.setViewPosition(deckHolder.getWidth() - deckViewport.getWidth(), 0);
+    }
+
+    //Trace button event
+    if (button == &traceButton)
+    {
+        toggleTrace();
+    }
+}
+
+void MainComponent::sliderValueChanged(juce::Slider* slider)
+{
+    //Crossfader slider event
+    if (slider == &crossfaderSlider)
+    {
+        mixer.setCrossfader((float) slider->getValue());
+    }
+}
+
+void MainComponent::comboBoxChanged(juce::ComboBox* comboBox)
+{
+    //Crossfader curve event
+    if (comboBox == &crossfaderCurveBox)
+    {
+        mixer.setCrossfaderCurve((DeckMixer::CrossfaderCurve) (comboBox->getSelectedId() - 1));
+    }
+
+    //Resampling quality event (every deck, and the decks added later)
+    if (comboBox == &qualityBox)
+    {
+        decks.setResamplingQuality((ResamplingKernel::Quality) (comboBox->getSelectedId() - 1));
+    }
+}
+
+void MainComponent::timerCallback()
+{
+    OTODESKS_PROFILE_SCOPE("MainComponent::timerCallback");
+
+    //Headroom left at the loudest peak so far, and how many blocks clipped
+    float peak = juce::jmax(mixer.takeMasterPeak(0), mixer.takeMasterPeak(1));
+    juce::String text = "Peak " + juce::String(juce::Decibels::gainToDecibels(peak), 1) + " dB"
+                        + "  Headroom " + juce::String(mixer.getHeadroomDb(), 1) + " dB";
+    if (mixer.getNumClips() > 0)
+    {
+        text << "  CLIP";
+    }
+
+    //CPU taken by the key lock of all decks (a share of one core)
+    double keyLockLoad = 0;
+    for (int i = 0; i < decks.getNumDecks(); ++i)
+    {
+        keyLockLoad += decks.getDeck(i)->getKeyLockLoad();
+    }
+    if (keyLockLoad > 0)
+    {
+        text << "  KEY " << juce::String(keyLockLoad * 100.0, 1) << "%";
+    }
+
+    if (renderPool.getNumLateBatches() > 0)   //Some decks missed the render deadline and were left out of a block
+    {
+        text << "  LATE " << renderPool.getNumLateBatches();
+    }
+
+    headroomLabel.setColour(juce::Label::textColourId, mixer.getNumClips() > 0 ? juce::Colours::red : juce::Colours::white);
+    headroomLabel.setText(text, juce::NotificationType::dontSendNotification);
+}
+
+
+
+
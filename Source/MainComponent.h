@@ -1,59 +1,110 @@
-#pragma once
-
-#include <JuceHeader.h>
-
-#include "DJAudioPlayer.h"
-#include "DeckGUI.h"
-#include "PlaylistComponent.h"
-#include "LibraryControl.h"
-
-
-//==============================================================================
-/*
-    This component lives inside our window, and this is where you should put all
-    your controls and content.
-*/
-class MainComponent  : public juce::AudioAppComponent,
-                       public juce::MixerAudioSource
-{
-public:
-    //==============================================================================
-    MainComponent();
-    ~MainComponent() override;
-
-    //==============================================================================
-    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
-    void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill) override;
-    void releaseResources() override;
-
-    //==============================================================================
-    void paint (juce::Graphics& g) override;
-    void resized() override;
-
-private:
-    //==============================================================================
-    // Your private member variables go here...
-
-    //Left audio player & left deckGUI
-    DJAudioPlayer player1{formatManager};
-    DeckGUI deckGUI1{&player1, formatManager, thumbCache, &playlistComponent};
-
-    //Right audio player & right deckGUI
-    DJAudioPlayer player2{formatManager};
-    DeckGUI deckGUI2{&player2, formatManager, thumbCache, &playlistComponent};
-
-    //Mix source of both audio players
-    MixerAudioSource mixerSource;
-
-    //Library control to upload file, save library, and upload library
-    LibraryControl libraryControl{&playlistComponent, formatManager};
-
-    //Library list table to store uploaded tracks
-    PlaylistComponent playlistComponent;
-    
-    //Audio format manager for the whole Otodecks app
-    juce::AudioFormatManager formatManager;
-    juce::AudioThumbnailCache thumbCache{100};
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
-};
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "Engine/DJAudioPlayer.h"
+#include "DeckGUI.h"
+#include "SamplerGUI.h"
+#include "PlaylistComponent.h"
+#include "LibraryControl.h"
+#include "Engine/DeckMixer.h"
+#include "Engine/DeckRenderPool.h"
+#include "Engine/DeckRegistry.h"
+#include "Engine/WaveformCache.h"
+#include "Engine/AudioProfiler.h"
+
+
+//==============================================================================
+/*
+    This component lives inside our window, and this is where you should put all
+    your controls and content.
+*/
+class MainComponent  : public juce::AudioAppComponent,
+                       public juce::Button::Listener,
+                       public juce::Slider::Listener,
+                       public juce::ComboBox::Listener,
+                       public juce::Timer
+{
+public:
+    //==============================================================================
+    MainComponent();
+    ~MainComponent() override;
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //==============================================================================
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+    //Virtual pure functions from Button::Listener
+    void buttonClicked(juce::Button* button) override;
+    //Virtual pure functions from Slider::Listener
+    void sliderValueChanged(juce::Slider* slider) override;
+    //Virtual pure functions from ComboBox::Listener
+    void comboBoxChanged(juce::ComboBox* comboBox) override;
+    //Virtual pure functions from Timer (headroom meter)
+    void timerCallback() override;
+
+private:
+    //==============================================================================
+    // Your private member variables go here...
+
+    //Create a deck (audio player and deckGUI), even decks go on side A of the crossfader and odd ones on side B
+    void addDeck();
+    //Create a sampler deck (audio player and samplerGUI), it plays over both sides of the crossfader
+    void addSampler();
+    //Start recording a profiler trace, or stop it and save it as Chrome trace JSON
+    void toggleTrace();
+
+    //Audio format manager for the whole Otodecks app (declared first so the background threads below never outlive it)
+    juce::AudioFormatManager formatManager;
+
+    //Disk thread that reads ahead for every deck (declared before the players so it outlives them)
+    juce::TimeSliceThread readAheadThread{ "Deck read-ahead" };
+
+    //Decoded tracks shared by all audio players (512 MB budget)
+    DecodedTrackCache trackCache{ formatManager, (size_t) 512 * 1024 * 1024 };
+
+    //Mixer of all audio players (channel faders, crossfader and headroom meter)
+    DeckMixer mixer;
+
+    //Audio players of all decks, created at runtime
+    DeckRegistry decks{ formatManager, readAheadThread, trackCache, mixer };
+
+    //Workers that render the decks in parallel (declared after the decks so they stop first)
+    DeckRenderPool renderPool{ juce::jlimit(0, 3, juce::SystemStats::getNumCpus() - 2) };
+
+    //Waveforms of the tracks of all decks (analysed once and kept on disk)
+    WaveformCache waveformCache{ formatManager, 64 };
+
+    //DeckGUIs, side by side in a scrolling view, and the samplerGUIs after them (declared after the decks so they go first)
+    juce::OwnedArray<DeckGUI> deckGUIs;
+    juce::OwnedArray<SamplerGUI> samplerGUIs;
+    juce::Viewport deckViewport;
+    juce::Component deckHolder;
+    juce::TextButton addDeckButton{ "ADD DECK" };
+    juce::TextButton addSamplerButton{ "ADD SAMPLER" };
+    juce::TextButton traceButton{ "TRACE" };
+
+    //Start of the previous audio callback and the device sample rate (to spot callbacks that come late)
+    juce::int64 lastCallbackTicks = 0;
+    double deviceSampleRate = 44100.0;
+
+    //Crossfader, its curve, and the headroom meter of the mixer
+    juce::Slider crossfaderSlider{ "XFADE" };
+    juce::ComboBox crossfaderCurveBox{ "XFADE CURVE" };
+    juce::Label headroomLabel{ "HEADROOM" };
+    //Interpolation the decks play their tracks with
+    juce::ComboBox qualityBox{ "SRC QUALITY" };
+
+    //Library list table to store uploaded tracks (declared first, the library control uses it from its constructor on)
+    PlaylistComponent playlistComponent;
+
+    //Library control to upload file, save library, and upload library
+    LibraryControl libraryControl{&playlistComponent, formatManager};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
+};
@@ -1,256 +1,381 @@
-/*
-  ==============================================================================
-
-    PlaylistComponent.cpp
-    Created: 20 Aug 2022 4:44:53pm
-    Author:  Api Rich
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "PlaylistComponent.h"
-
-//==============================================================================
-PlaylistComponent::PlaylistComponent() : selectedRow(-1)
-{
-    //Make the table list library visible on the GUI layout
-    addAndMakeVisible(tableComponent);
-
-    //Set the table list library as TableListBoxModel
-    tableComponent.setModel(this);
-    //Set LookandFeel for the table list library
-    tableComponent.setLookAndFeel(&customTable);
-    //Set the table list library background color (not including header)
-    tableComponent.setColour(juce::TableListBox::backgroundColourId, juce::Colours::darkslategrey);
-    //Set the table list library text color
-    tableComponent.getHeader().setColour(juce::TableHeaderComponent::textColourId, juce::Colours::white);
-
-    //Add columns to the table list library
-    tableComponent.getHeader().addColumn("Track Title", 1, 500);
-    tableComponent.getHeader().addColumn("Duration", 2, 150);
-    tableComponent.getHeader().addColumn("Delete", 3, 150);
-   
-}
-
-PlaylistComponent::~PlaylistComponent()
-{
-}
-
-void PlaylistComponent::paint (juce::Graphics& g)
-{
-    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
-}
-
-void PlaylistComponent::resized()
-{
-    //Set the size of the table list library
-    tableComponent.setBounds(0, 0, getWidth(), getHeight());
-}
-
-int PlaylistComponent::getNumRows()
-{
-    //Set number of row as the number of tracks that are stored in the data vectors
-    return trackTitles.size();
-}
-
-void PlaylistComponent::paintRowBackground(juce::Graphics& g, 
-                                           int rowNumber, 
-                                           int width, 
-                                           int height, 
-                                           bool rowIsSelected)
-{
-    if (rowIsSelected)  //Set row background color when it is selected
-    {
-        g.fillAll(juce::Colours::darkgrey);
-    }
-    else  //Set row background color when it is not selected
-    {
-        g.fillAll(juce::Colours::darkslategrey);
-    }
-}
-
-void PlaylistComponent::paintCell(juce::Graphics& g, 
-                                  int rowNumber, 
-                                  int columnId, 
-                                  int width, 
-                                  int height, 
-                                  bool rowIsSelected)
-{
-    //Set text color for all cells
-    g.setColour(juce::Colours::white);
-
-    //Draw titles of tracks
-    if (columnId == 1)
-    {
-        g.drawText(trackTitles[rowNumber],
-                   2, 0,
-                   width - 4, height,
-                   juce::Justification::centredLeft, true);
-    }
-    //Draw durations of tracks
-    if (columnId == 2)
-    { 
-        g.drawText(trackDurations[rowNumber],
-            2, 0,
-            width - 4, height,
-            juce::Justification::centredLeft, true);
-    }
-}
-
-juce::Component* PlaylistComponent::refreshComponentForCell(int rowNumber,
-                                                            int columnId,
-                                                            bool isRowSelected,
-                                                            juce::Component* existingComponentToUpdate)
-{
-    //Create delete button on each row
-    if (columnId == 3)
-    {
-        if (existingComponentToUpdate == nullptr)
-        {
-            juce::TextButton* btn = new juce::TextButton{ "Delete" };       
-
-            juce::String id{ std::to_string(rowNumber) };
-            btn->setComponentID(id);
-
-            btn->addListener(this);
-
-            existingComponentToUpdate = btn;
-        }
-    }
-
-    return existingComponentToUpdate;
-}
-
-void PlaylistComponent::buttonClicked(juce::Button* button)
-{
-    //Clear the data of a track when it is chosen to be deleted
-    int id = std::stoi(button->getComponentID().toStdString());
-    std::cout << "PlaylistComponent::buttonClicked " << trackTitles[id] << std::endl;
-    trackFiles.erase(trackFiles.begin() + id);
-    trackTitles.erase(trackTitles.begin() + id);
-    trackURLs.erase(trackURLs.begin() + id);
-    trackDurations.erase(trackDurations.begin() + id);
-    trackDurSec.erase(trackDurSec.begin() + id);
-    tableComponent.updateContent();
-}
-
-void PlaylistComponent::addNewTrack(juce::File trackFile, std::string fileName, juce::URL fileURL, double length)
-{
-    //Check if a track is already in the table list library
-    for (int i = 0; i < trackTitles.size(); ++i)
-    {
-        if (fileName == trackTitles[i])
-        {
-            std::cout << "This track title already has been added in the list!" << std::endl;
-            return;
-        }
-    }
-
-    //If a track is not yet in the table list library, then add it in
-    //Convert length into hr:min:sec 
-    double hour = trunc(length / 3600);
-    double min = trunc((length - (hour * 3600)) / 60);
-    double sec = trunc(length - (hour * 3600) - (min * 60));
-    //Store hr:min:sec as a string (duration)
-    std::string duration = std::to_string((int)hour) + ":" + std::to_string((int)min) + ":" + std::to_string((int)sec);
-    //Store data of the track into data vectors
-    trackFiles.push_back(trackFile);
-    trackTitles.push_back(fileName);
-    trackURLs.push_back(fileURL);
-    trackDurations.push_back(duration);
-    trackDurSec.push_back(length);
-    //Update the content of the table list library
-    tableComponent.updateContent();
-}
-
-
-void PlaylistComponent::selectedRowsChanged(int lastRowSelected)
-{
-    //Store lastRowSelected in selectedRow variable
-    selectedRow = lastRowSelected;
-    std::cout << lastRowSelected << std::endl;
-}
-
-juce::URL PlaylistComponent::loadChosenTrackURL()
-{
-    //Return URL of a track (lastRowSelected) for DeckGUI to Deckin tracks
-    if (selectedRow != -1)
-    {
-        return trackURLs[selectedRow];
-    }
-    else
-    {
-        std::cout << "PlaylistComponent::loadChosenTrack() No track has been selected!" << std::endl;
-        return juce::URL();
-    }
-}
-
-std::string PlaylistComponent::loadChosenTrackTitle()
-{
-    //Return title of a track (lastRowSelected) for DeckGUI to Deckin tracks
-    if (selectedRow != -1)
-    {
-        return trackTitles[selectedRow];
-    }
-    else
-    {
-        std::cout << "PlaylistComponent::loadChosenTrack() No track has been selected!" << std::endl;
-        return std::string();
-    }
-}
-
-double PlaylistComponent::loadChosenTrackDurSec()
-{
-    //Return duration of a track (lastRowSelected) for DeckGUI to Deckin tracks
-    if (selectedRow != -1)
-    {
-        return trackDurSec[selectedRow];
-    }
-    else
-    {
-        std::cout << "PlaylistComponent::loadChosenTrack() No track has been selected!" << std::endl;
-        return double();
-    }
-}
-
-
-void PlaylistComponent::saveLibrary(juce::File tempFile)
-{
-    //Looping through the file vectors 
-    //and copy all of the files to the directory that was chosen from the filechooser from Save Library button (in LibraryControl.cpp)
-    for (int i = 0; i < trackFiles.size(); ++i)
-    {
-        std::string trackExt = trackFiles[i].getFileExtension().toStdString();
-        std::string trackOutExt = trackTitles[i] + trackExt;
-        trackFiles[i].copyFileTo(tempFile.getChildFile(trackOutExt));
-    }
-}
-
-void PlaylistComponent::loadLibrary()
-{
-    //Clear all current data on the table list library and update its content
-    trackFiles.clear();
-    trackTitles.clear();
-    trackURLs.clear();
-    trackDurations.clear();
-    tableComponent.updateContent();
-    std::cout << "PlaylistComponent::loadLibrary all clear" << std::endl;
-}
-
-std::vector<std::string> PlaylistComponent::searchLibrary()
-{
-    //Return the titles vector for the searchInput (in LibraryControl.cpp)
-    return trackTitles;
-}
-
-void PlaylistComponent::chooseRow(int rowNum)
-{
-    //Receive the row number of the search track in searchInput (in LibraryControl.cpp)
-    //and select the row 
-    //(when user search for a track, if it is currently on the table list library, its row will be automatically selected)
-    tableComponent.selectRow(rowNum);
-}
-
-
-
+/*
+  ==============================================================================
+
+    PlaylistComponent.cpp
+    Created: 20 Aug 2022 4:44:53pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PlaylistComponent.h"
+
+//==============================================================================
+PlaylistComponent::PlaylistComponent() : selectedTrack(TrackStore::invalidId)
+{
+    //Update the table (once) whenever the tracks change
+    tracks.addChangeListener(this);
+
+    //Make the table list library visible on the GUI layout
+    addAndMakeVisible(tableComponent);
+
+    //Set the table list library as TableListBoxModel
+    tableComponent.setModel(this);
+    //Set LookandFeel for the table list library
+    tableComponent.setLookAndFeel(&customTable);
+    //Set the table list library background color (not including header)
+    tableComponent.setColour(juce::TableListBox::backgroundColourId, juce::Colours::darkslategrey);
+    //Set the table list library text color
+    tableComponent.getHeader().setColour(juce::TableHeaderComponent::textColourId, juce::Colours::white);
+
+    //Add columns to the table list library
+    tableComponent.getHeader().addColumn("Track Title", 1, 500);
+    tableComponent.getHeader().addColumn("Duration", 2, 150);
+    tableComponent.getHeader().addColumn("Delete", 3, 150);
+
+    //Bring back the library of the last session from its index (no track file is opened)
+    LibraryIndex index;
+    if (index.load(LibraryIndex::getAppLibraryFile()))
+    {
+        tracks.addBatch(index.getTracks());
+        libraryRoots = index.getRoots();
+    }
+}
+
+PlaylistComponent::~PlaylistComponent()
+{
+    tracks.removeChangeListener(this);
+
+    //Changes not saved yet
+    if (isTimerRunning())
+    {
+        saveIndex();
+    }
+}
+
+void PlaylistComponent::paint (juce::Graphics& g)
+{
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
+}
+
+void PlaylistComponent::resized()
+{
+    //Set the size of the table list library
+    tableComponent.setBounds(0, 0, getWidth(), getHeight());
+}
+
+int PlaylistComponent::getNumRows()
+{
+    //Set number of row as the number of tracks that are stored in the track store (or that match the search)
+    return filtered ? (int) filteredTracks.size() : tracks.getNumRows();
+}
+
+void PlaylistComponent::paintRowBackground(juce::Graphics& g, 
+                                           int rowNumber, 
+                                           int width, 
+                                           int height, 
+                                           bool rowIsSelected)
+{
+    if (rowIsSelected)  //Set row background color when it is selected
+    {
+        g.fillAll(juce::Colours::darkgrey);
+    }
+    else  //Set row background color when it is not selected
+    {
+        g.fillAll(juce::Colours::darkslategrey);
+    }
+}
+
+void PlaylistComponent::paintCell(juce::Graphics& g, 
+                                  int rowNumber, 
+                                  int columnId, 
+                                  int width, 
+                                  int height, 
+                                  bool rowIsSelected)
+{
+    auto id = getIdAtRow(rowNumber);
+    if (id == TrackStore::invalidId)
+    {
+        return;
+    }
+
+    //Set text color for all cells
+    g.setColour(juce::Colours::white);
+
+    //Draw titles of tracks
+    if (columnId == 1)
+    {
+        g.drawText(tracks.getTitle(id),
+                   2, 0,
+                   width - 4, height,
+                   juce::Justification::centredLeft, true);
+    }
+    //Draw durations of tracks
+    if (columnId == 2)
+    { 
+        g.drawText(TrackStore::formatDuration(tracks.getLengthInSeconds(id)),
+            2, 0,
+            width - 4, height,
+            juce::Justification::centredLeft, true);
+    }
+}
+
+juce::Component* PlaylistComponent::refreshComponentForCell(int rowNumber,
+                                                            int columnId,
+                                                            bool isRowSelected,
+                                                            juce::Component* existingComponentToUpdate)
+{
+    //Create delete button on each row
+    if (columnId == 3)
+    {
+        if (existingComponentToUpdate == nullptr)
+        {
+            juce::TextButton* btn = new juce::TextButton{ "Delete" };       
+
+            btn->addListener(this);
+
+            existingComponentToUpdate = btn;
+        }
+
+        //Buttons are reused for other rows as the table scrolls or changes, so the ID of the track is set every time
+        existingComponentToUpdate->setComponentID(juce::String(getIdAtRow(rowNumber)));
+    }
+
+    return existingComponentToUpdate;
+}
+
+void PlaylistComponent::buttonClicked(juce::Button* button)
+{
+    //Clear the data of a track when it is chosen to be deleted
+    auto id = (TrackStore::TrackId) button->getComponentID().getLargeIntValue();
+    if (!tracks.contains(id))
+    {
+        return;
+    }
+
+    std::cout << "PlaylistComponent::buttonClicked " << tracks.getTitle(id) << std::endl;
+    tracks.remove(id);
+}
+
+void PlaylistComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    //Search again, the tracks found may have changed
+    if (filtered)
+    {
+        filteredTracks = searchIndex.search(filterQuery);
+    }
+
+    //Update the content of the table list library, and keep the chosen track selected wherever its row is now
+    tableComponent.updateContent();
+    int row = getRowOf(selectedTrack);
+    if (row >= 0)
+    {
+        tableComponent.selectRow(row, false, true);
+    }
+    else
+    {
+        selectedTrack = TrackStore::invalidId;
+        tableComponent.deselectAllRows();
+    }
+    tableComponent.repaint();
+
+    //Save the index once the changes have settled
+    startTimer(2000);
+}
+
+void PlaylistComponent::timerCallback()
+{
+    stopTimer();
+    saveIndex();
+}
+
+void PlaylistComponent::saveIndex()
+{
+    if (!LibraryIndex::save(LibraryIndex::getAppLibraryFile(), getLibraryTracks(), libraryRoots))
+    {
+        std::cout << "PlaylistComponent::saveIndex the library index could not be saved" << std::endl;
+    }
+}
+
+void PlaylistComponent::addNewTrack(const TrackStore::TrackInfo& track)
+{
+    addNewTracks({ track });
+}
+
+void PlaylistComponent::addNewTracks(const std::vector<TrackStore::TrackInfo>& newTracks)
+{
+    //Store data of the tracks into the track store (files already there are left out)
+    auto ids = tracks.addBatch(newTracks);
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        if (ids[i] != TrackStore::invalidId)
+        {
+            //Index a compressed track in the background, so seeking in it never decodes from far back
+            seekIndexBuilder.request(newTracks[i].file);
+        }
+    }
+}
+
+void PlaylistComponent::reindexTracks(const std::vector<TrackStore::TrackInfo>& changedTracks)
+{
+    for (const auto& track : changedTracks)
+    {
+        seekIndexBuilder.request(track.file);
+    }
+}
+
+TrackStore& PlaylistComponent::getTrackStore()
+{
+    return tracks;
+}
+
+void PlaylistComponent::setLibraryRoots(const std::vector<juce::File>& roots)
+{
+    libraryRoots = roots;
+    startTimer(2000);
+}
+
+const std::vector<juce::File>& PlaylistComponent::getLibraryRoots() const
+{
+    return libraryRoots;
+}
+
+std::vector<TrackStore::TrackInfo> PlaylistComponent::getLibraryTracks() const
+{
+    std::vector<TrackStore::TrackInfo> library;
+    library.reserve((size_t) tracks.getNumRows());
+    for (int row = 0; row < tracks.getNumRows(); ++row)
+    {
+        library.push_back(tracks.getInfo(tracks.getIdAtRow(row)));
+    }
+    return library;
+}
+
+
+void PlaylistComponent::selectedRowsChanged(int lastRowSelected)
+{
+    //Store the track of lastRowSelected in selectedTrack variable
+    selectedTrack = getIdAtRow(lastRowSelected);
+    std::cout << lastRowSelected << std::endl;
+}
+
+juce::URL PlaylistComponent::loadChosenTrackURL()
+{
+    //Return URL of a track (lastRowSelected) for DeckGUI to Deckin tracks
+    if (tracks.contains(selectedTrack))
+    {
+        return tracks.getURL(selectedTrack);
+    }
+    else
+    {
+        std::cout << "PlaylistComponent::loadChosenTrack() No track has been selected!" << std::endl;
+        return juce::URL();
+    }
+}
+
+std::string PlaylistComponent::loadChosenTrackTitle()
+{
+    //Return title of a track (lastRowSelected) for DeckGUI to Deckin tracks
+    if (tracks.contains(selectedTrack))
+    {
+        return tracks.getTitle(selectedTrack);
+    }
+    else
+    {
+        std::cout << "PlaylistComponent::loadChosenTrack() No track has been selected!" << std::endl;
+        return std::string();
+    }
+}
+
+double PlaylistComponent::loadChosenTrackDurSec()
+{
+    //Return duration of a track (lastRowSelected) for DeckGUI to Deckin tracks
+    if (tracks.contains(selectedTrack))
+    {
+        return tracks.getLengthInSeconds(selectedTrack);
+    }
+    else
+    {
+        std::cout << "PlaylistComponent::loadChosenTrack() No track has been selected!" << std::endl;
+        return double();
+    }
+}
+
+
+void PlaylistComponent::saveLibrary(juce::File tempFile)
+{
+    //Write a playlist and an index of the tracks, referenced where they are, to the directory that was chosen
+    //from the filechooser from Save Library button (in LibraryControl.cpp), the tracks are not copied
+    if (!LibraryExporter::saveReferences(tempFile, getLibraryTracks(), libraryRoots))
+    {
+        std::cout << "PlaylistComponent::saveLibrary the library could not be saved" << std::endl;
+    }
+}
+
+void PlaylistComponent::loadLibrary()
+{
+    //Clear all current data on the table list library (its content is updated by the change message)
+    tracks.clear();
+    std::cout << "PlaylistComponent::loadLibrary all clear" << std::endl;
+}
+
+int PlaylistComponent::filterLibrary(const std::string& query)
+{
+    //Show only the tracks matching the search of the searchInput (in LibraryControl.cpp), best first,
+    //or all of them again when it is empty; returns the number of rows
+    auto found = searchIndex.search(query);
+    filtered = !SearchIndex::splitWords(query).empty();
+    filterQuery = query;
+    filteredTracks = std::move(found);
+
+    tableComponent.updateContent();
+    int row = getRowOf(selectedTrack);
+    if (row >= 0)
+    {
+        tableComponent.selectRow(row, false, true);
+    }
+    else
+    {
+        tableComponent.deselectAllRows();
+    }
+    tableComponent.repaint();
+    return getNumRows();
+}
+
+TrackStore::TrackId PlaylistComponent::getIdAtRow(int row) const
+{
+    if (!filtered)
+    {
+        return tracks.getIdAtRow(row);
+    }
+    if (!juce::isPositiveAndBelow(row, (int) filteredTracks.size()))
+    {
+        return TrackStore::invalidId;
+    }
+
+    //A track deleted since the search is still in the results until the change message comes, it is left blank until then
+    auto id = filteredTracks[(size_t) row];
+    return tracks.contains(id) ? id : TrackStore::invalidId;
+}
+
+int PlaylistComponent::getRowOf(TrackStore::TrackId id) const
+{
+    if (!filtered)
+    {
+        return tracks.getRowOf(id);
+    }
+    auto it = std::find(filteredTracks.begin(), filteredTracks.end(), id);
+    return it != filteredTracks.end() ? (int) (it - filteredTracks.begin()) : -1;
+}
+
+void PlaylistComponent::chooseRow(int rowNum)
+{
+    //Receive the row number of the search track in searchInput (in LibraryControl.cpp)
+    //and select the row 
+    //(when user search for a track, if it is currently on the table list library, its row will be automatically selected)
+    tableComponent.selectRow(rowNum);
+}
+
+
+
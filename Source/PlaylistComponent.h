@@ -1,96 +1,132 @@
-/*
-  ==============================================================================
-
-    PlaylistComponent.h
-    Created: 20 Aug 2022 4:44:53pm
-    Author:  Api Rich
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include <vector>
-#include <string>
-#include <iostream>
-#include <fstream>
-
-#include "CustomLookAndFeel.h"
-
-
-//==============================================================================
-/*
-*/
-class PlaylistComponent  : public juce::TableListBox,
-                           public juce::TableListBoxModel,
-                           public juce::Button::Listener
-{
-public:
-    PlaylistComponent();
-    ~PlaylistComponent() override;
-
-    void paint (juce::Graphics&) override;
-    void resized() override;
-
-    //Virtual pure functions from TableListBoxModel
-    int getNumRows() override;
-    void paintRowBackground(juce::Graphics&, 
-                            int rowNumber, 
-                            int width, 
-                            int height, 
-                            bool rowIsSelected) override;
-    void paintCell(juce::Graphics&, 
-                   int rowNumber, 
-                   int columnId, 
-                   int width, 
-                   int height, 
-                   bool rowIsSelected) override;
-    //Override function from TableListBoxModel
-    juce::Component* refreshComponentForCell(int rowNumber, 
-                                       int columnId, 
-                                       bool isRowSelected, 
-                                       Component* existingComponentToUpdate) override;
-
-    //Virtual pure functions from Button::Listener
-    void buttonClicked(juce::Button* button) override;
-
-    //Receive a file from the browsers (import button and loadLibrary button in LibraryControl)
-    //and store its data into the vectors, and then add them on the table list library
-    void addNewTrack(juce::File, std::string fileName, juce::URL fileURL, double length);
-  
-    //Override function from TableListBox
-    void selectedRowsChanged(int lastRowSelected) override;
-
-    //Return data for DeckGUI to Deckin tracks
-    juce::URL loadChosenTrackURL();
-    std::string loadChosenTrackTitle();
-    double loadChosenTrackDurSec();
-
-    //Retrieve current data on the table list library to save library 
-    void saveLibrary(juce::File tempFile);
-    //Clear all current data on the table list library to load library with its data
-    void loadLibrary();
-
-    //Search to see if a track is currently store on the table list library
-    std::vector<std::string> searchLibrary();
-    //If the search track is currently store on the table list library, select its row
-    void chooseRow(int rowNum);
-
-private:
-    //The table list library
-    juce::TableListBox tableComponent;
-    //LookAndFeel (custom graphic) for the table list library
-    CustomLookAndFeel customTable;
-
-    //Vectors to store data from received files
-    std::vector<juce::File> trackFiles;
-    std::vector<std::string> trackTitles;
-    std::vector<juce::URL> trackURLs;
-    std::vector<std::string> trackDurations;
-    std::vector<double> trackDurSec;
-
-    //Store the last row selected from the table list library (to Deckin its data)
-    double selectedRow;
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaylistComponent)
-};
+/*
+  ==============================================================================
+
+    PlaylistComponent.h
+    Created: 20 Aug 2022 4:44:53pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <fstream>
+
+#include "CustomLookAndFeel.h"
+#include "Engine/SeekIndex.h"
+#include "Library/TrackStore.h"
+#include "Library/LibraryIndex.h"
+#include "Library/LibraryExporter.h"
+#include "Library/SearchIndex.h"
+
+
+//==============================================================================
+/*
+*/
+class PlaylistComponent  : public juce::TableListBox,
+                           public juce::TableListBoxModel,
+                           public juce::Button::Listener,
+                           public juce::ChangeListener,
+                           public juce::Timer
+{
+public:
+    PlaylistComponent();
+    ~PlaylistComponent() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    //Virtual pure functions from TableListBoxModel
+    int getNumRows() override;
+    void paintRowBackground(juce::Graphics&, 
+                            int rowNumber, 
+                            int width, 
+                            int height, 
+                            bool rowIsSelected) override;
+    void paintCell(juce::Graphics&, 
+                   int rowNumber, 
+                   int columnId, 
+                   int width, 
+                   int height, 
+                   bool rowIsSelected) override;
+    //Override function from TableListBoxModel
+    juce::Component* refreshComponentForCell(int rowNumber, 
+                                       int columnId, 
+                                       bool isRowSelected, 
+                                       Component* existingComponentToUpdate) override;
+
+    //Virtual pure functions from Button::Listener
+    void buttonClicked(juce::Button* button) override;
+
+    //Virtual pure functions from ChangeListener
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    //Virtual pure functions from Timer (saves the library index a moment after the last change)
+    void timerCallback() override;
+
+    //Receive a file from the browsers (import button and loadLibrary button in LibraryControl)
+    //and store its data into the track store, and then add them on the table list library
+    void addNewTrack(const TrackStore::TrackInfo& track);
+    //Add many tracks at once (the table is updated once for all of them)
+    void addNewTracks(const std::vector<TrackStore::TrackInfo>& newTracks);
+    //Tracks whose files have changed, their seek tables are built again
+    void reindexTracks(const std::vector<TrackStore::TrackInfo>& changedTracks);
+
+    //The tracks of the table list library (the library watcher keeps them in step with their folders)
+    TrackStore& getTrackStore();
+    //Folders the library is loaded from (kept in the library index)
+    void setLibraryRoots(const std::vector<juce::File>& roots);
+    const std::vector<juce::File>& getLibraryRoots() const;
+    //The tracks in table order
+    std::vector<TrackStore::TrackInfo> getLibraryTracks() const;
+  
+    //Override function from TableListBox
+    void selectedRowsChanged(int lastRowSelected) override;
+
+    //Return data for DeckGUI to Deckin tracks
+    juce::URL loadChosenTrackURL();
+    std::string loadChosenTrackTitle();
+    double loadChosenTrackDurSec();
+
+    //Retrieve current data on the table list library to save library (a playlist and an index referencing the tracks)
+    void saveLibrary(juce::File tempFile);
+    //Clear all current data on the table list library to load library with its data
+    void loadLibrary();
+
+    //Show only the tracks matching a search on the table list library (all of them for an empty one), returns the number of rows
+    int filterLibrary(const std::string& query);
+    //If the search track is currently store on the table list library, select its row
+    void chooseRow(int rowNum);
+
+private:
+    //The table list library
+    juce::TableListBox tableComponent;
+    //LookAndFeel (custom graphic) for the table list library
+    CustomLookAndFeel customTable;
+
+    //Tracks of the table list library, and the folders they are loaded from
+    TrackStore tracks;
+    std::vector<juce::File> libraryRoots;
+    //Write the tracks to the index of the app library
+    void saveIndex();
+
+    //Search index of the tracks, and the tracks the table shows while it is filtered by a search
+    SearchIndex searchIndex{ tracks };
+    std::vector<TrackStore::TrackId> filteredTracks;
+    std::string filterQuery;
+    bool filtered = false;
+    //Track of a row of the table (invalidId if it has been deleted), and row of a track (-1 if the table does not show it)
+    TrackStore::TrackId getIdAtRow(int row) const;
+    int getRowOf(TrackStore::TrackId id) const;
+
+    //Store the track of the last row selected from the table list library (to Deckin its data)
+    TrackStore::TrackId selectedTrack;
+
+    //Seek tables of the compressed tracks, built in the background as they are added
+    SeekIndexBuilder seekIndexBuilder;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaylistComponent)
+};
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    SamplerGUI.cpp
+    Created: 2 Oct 2022 3:18:40pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SamplerGUI.h"
+
+//==============================================================================
+SamplerGUI::SamplerGUI(DJAudioPlayer* _player,
+                       PlaylistComponent* _playList) : player(_player),
+                                                       playList(_playList)
+{
+    //Make all buttons, the slider and the title visible
+    addAndMakeVisible(loadButton);
+    addAndMakeVisible(hitButton);
+    addAndMakeVisible(loopBoxButton);
+    addAndMakeVisible(stopButton);
+    addAndMakeVisible(volSlider);
+    addAndMakeVisible(titleLabel);
+
+    //Register listener to all buttons and the slider
+    loadButton.addListener(this);
+    hitButton.addListener(this);
+    loopBoxButton.addListener(this);
+    stopButton.addListener(this);
+    volSlider.addListener(this);
+
+    //Vol slider, vertical with the textbox below
+    volSlider.setRange(0.0, 1.0);
+    volSlider.setValue(0.8, juce::NotificationType::dontSendNotification);
+    volSlider.setSliderStyle(juce::Slider::SliderStyle::LinearVertical);
+    volSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 40, 15);
+
+    titleLabel.setText("EMPTY SAMPLER", juce::NotificationType::dontSendNotification);
+    titleLabel.setJustificationType(juce::Justification::centred);
+
+    //Nothing to play until a sample is loaded
+    hitButton.setEnabled(false);
+    loopBoxButton.setEnabled(false);
+    stopButton.setEnabled(false);
+    volSlider.setEnabled(false);
+
+    //Listen to the audio player for samples that are ready
+    player->addListener(this);
+    player->setGain(volSlider.getValue());
+}
+
+SamplerGUI::~SamplerGUI()
+{
+    player->removeListener(this);
+}
+
+void SamplerGUI::paint (juce::Graphics& g)
+{
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
+
+    g.setColour (juce::Colours::mediumturquoise);
+    g.drawRect (getLocalBounds(), 1);   // draw an outline around the component
+}
+
+void SamplerGUI::resized()
+{
+    int rowH = getHeight() / 8;
+    int colW = getWidth() / 2;
+
+    //Title on top, buttons on the left, and the vol slider on the right
+    titleLabel.setBounds(5, 5, getWidth() - 10, rowH);
+    loadButton.setBounds(5, 3 * rowH / 2, colW - 10, rowH);
+    hitButton.setBounds(5, 3 * rowH, colW - 10, 2 * rowH);
+    loopBoxButton.setBounds(5, 11 * rowH / 2, colW - 10, rowH);
+    stopButton.setBounds(5, 27 * rowH / 4, colW - 10, rowH);
+    volSlider.setBounds(colW, 3 * rowH / 2, colW - 5, getHeight() - 3 * rowH / 2 - 5);
+}
+
+void SamplerGUI::buttonClicked(juce::Button* button)
+{
+    //Load button event
+    if (button == &loadButton)
+    {
+        if (!playList->loadChosenTrackTitle().empty())   //If the table list library is not empty
+        {
+            titleLabel.setText(playList->loadChosenTrackTitle(), juce::NotificationType::dontSendNotification);
+
+            //Decode the whole sample into the shared cache, so a hit never waits for the disk
+            player->prefetch(playList->loadChosenTrackURL());
+            player->loadURL(playList->loadChosenTrackURL(), loopBoxButton.getToggleState());
+        }
+    }
+
+    //Hit button event, the sample always starts again from the top
+    if (button == &hitButton)
+    {
+        player->setPosition(0);
+        player->play();
+    }
+
+    //Loop button event
+    if (button == &loopBoxButton)
+    {
+        player->setLooping(loopBoxButton.getToggleState());
+    }
+
+    //Stop button event
+    if (button == &stopButton)
+    {
+        player->stop();
+    }
+}
+
+void SamplerGUI::sliderValueChanged(juce::Slider* slider)
+{
+    //Vol slider event
+    if (slider == &volSlider)
+    {
+        player->setGain(slider->getValue());
+    }
+}
+
+void SamplerGUI::trackReady(DJAudioPlayer* readyPlayer, const juce::URL& audioURL, bool loaded)
+{
+    //A sample that could not be opened leaves the previous one (if any) loaded
+    if (!loaded)
+    {
+        titleLabel.setText("CANNOT LOAD SAMPLE", juce::NotificationType::dontSendNotification);
+        return;
+    }
+
+    hitButton.setEnabled(true);
+    loopBoxButton.setEnabled(true);
+    stopButton.setEnabled(true);
+    volSlider.setEnabled(true);
+}
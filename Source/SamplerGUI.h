@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    SamplerGUI.h
+    Created: 2 Oct 2022 3:18:40pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Engine/DJAudioPlayer.h"
+#include "PlaylistComponent.h"
+
+//==============================================================================
+/*
+    A sampler deck: one sample from the table list library, fired from the
+    start by the HIT button, and played over both sides of the crossfader.
+*/
+class SamplerGUI  : public juce::Component,
+                    public juce::Button::Listener,
+                    public juce::Slider::Listener,
+                    public DJAudioPlayer::Listener
+{
+public:
+    SamplerGUI(DJAudioPlayer* _player,
+               PlaylistComponent* _playList);
+    ~SamplerGUI() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    //Virtual pure functions from Button::Listener
+    void buttonClicked(juce::Button*) override;
+
+    //Virtual pure functions from Slider::Listener
+    void sliderValueChanged(juce::Slider* slider) override;
+
+    //Virtual pure functions from DJAudioPlayer::Listener
+    void trackReady(DJAudioPlayer* readyPlayer, const juce::URL& audioURL, bool loaded) override;
+
+private:
+    //Load, hit, loop and stop buttons
+    juce::TextButton loadButton{ "LOAD" };
+    juce::TextButton hitButton{ "HIT" };
+    juce::ToggleButton loopBoxButton{ "LOOP" };
+    juce::TextButton stopButton{ "STOP" };
+
+    //Vol slider
+    juce::Slider volSlider;
+
+    //Title of the loaded sample
+    juce::Label titleLabel;
+
+    DJAudioPlayer* player;
+    PlaylistComponent* playList;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplerGUI)
+};
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    ScrollingWaveformDisplay.cpp
+    Created: 3 Oct 2022 4:12:51pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "ScrollingWaveformDisplay.h"
+
+//==============================================================================
+ScrollingWaveformDisplay::ScrollingWaveformDisplay(WaveformCache& cacheToUse) : waveformCache(cacheToUse)
+{
+    //Every pixel is painted, nothing behind it has to be
+    setOpaque(true);
+    waveformCache.addChangeListener(this);
+}
+
+ScrollingWaveformDisplay::~ScrollingWaveformDisplay()
+{
+    waveformCache.removeChangeListener(this);
+}
+
+void ScrollingWaveformDisplay::paint (juce::Graphics& g)
+{
+    OTODESKS_PROFILE_SCOPE("ScrollingWaveformDisplay::paint");
+
+    g.fillAll(juce::Colours::black);
+
+    int width = getWidth();
+    float centre = getHeight() * 0.5f;
+
+    if (waveform != nullptr && width > 0)
+    {
+        double samplesPerPixel = getSamplesPerPixel();
+        int level = waveform->getLevelFor(samplesPerPixel);
+        float peakScale = centre / 127.0f;
+
+        //Track pixels from the left edge, the playhead pixel is in the middle
+        juce::int64 firstPixel = playheadPixel - width / 2;
+        for (int x = 0; x < width; ++x)
+        {
+            auto start = (juce::int64) ((firstPixel + x) * samplesPerPixel);
+            auto end = (juce::int64) ((firstPixel + x + 1) * samplesPerPixel);
+            if (end <= 0 || start >= waveform->getLengthInSamples())   //Before or after the track
+            {
+                continue;
+            }
+
+            //Bands relative to the strongest one, so quiet passages keep their colour
+            auto bin = waveform->getRange(level, juce::jmax((juce::int64) 0, start), end);
+            float strongest = (float) juce::jmax(1, (int) juce::jmax(bin.low, bin.mid, bin.high));
+            g.setColour(juce::Colour::fromFloatRGBA(bin.low / strongest, bin.mid / strongest, bin.high / strongest, 1.0f));
+            g.drawVerticalLine(x, centre - bin.max * peakScale, centre - bin.min * peakScale + 1.0f);
+        }
+    }
+    else if (!trackURL.isEmpty())   //Still being analysed, or could not be
+    {
+        g.setColour(juce::Colours::darkturquoise);
+        g.setFont(14.0f);
+        g.drawFittedText(analysisFailed ? "Cannot analyse this track" : "Analysing...", getLocalBounds(), juce::Justification::centred, 1);
+    }
+
+    //Playhead, and the centre line
+    g.setColour(juce::Colours::white.withAlpha(0.2f));
+    g.drawHorizontalLine(juce::roundToInt(centre), 0.0f, (float) width);
+    g.setColour(juce::Colours::darkred);
+    g.fillRect(width / 2 - 1, 0, 2, getHeight());
+}
+
+void ScrollingWaveformDisplay::resized()
+{
+    //Same position, new number of samples per pixel
+    setPositionInSeconds(positionInSeconds);
+    repaint();
+}
+
+void ScrollingWaveformDisplay::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    //A waveform has become ready (or failed), which may be the one of the chosen track
+    if (!trackURL.isEmpty() && waveform == nullptr && !analysisFailed)
+    {
+        waveform = waveformCache.get(trackURL);
+        analysisFailed = waveform == nullptr && waveformCache.hasFailed(trackURL);
+        if (waveform != nullptr)
+        {
+            setPositionInSeconds(positionInSeconds);
+        }
+        if (waveform != nullptr || analysisFailed)
+        {
+            repaint();
+        }
+    }
+}
+
+void ScrollingWaveformDisplay::loadURL(juce::URL audioURL)
+{
+    trackURL = audioURL;
+    waveform = waveformCache.get(audioURL);
+    analysisFailed = !audioURL.isEmpty() && waveform == nullptr && waveformCache.hasFailed(audioURL);
+    positionInSeconds = 0;
+    playheadPixel = 0;
+    repaint();
+}
+
+void ScrollingWaveformDisplay::setPositionInSeconds(double seconds)
+{
+    positionInSeconds = seconds;
+    if (waveform == nullptr || getWidth() <= 0)
+    {
+        return;
+    }
+
+    //The view moves in whole track pixels
+    auto pixel = (juce::int64) std::floor(seconds * waveform->getSampleRate() / getSamplesPerPixel());
+    if (pixel != playheadPixel)
+    {
+        playheadPixel = pixel;
+        repaint();
+    }
+}
+
+double ScrollingWaveformDisplay::getSamplesPerPixel() const
+{
+    return 2.0 * secondsEachSide * waveform->getSampleRate() / juce::jmax(1, getWidth());
+}
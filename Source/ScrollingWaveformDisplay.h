@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    ScrollingWaveformDisplay.h
+    Created: 3 Oct 2022 4:12:51pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Engine/AudioProfiler.h"
+#include "Engine/WaveformCache.h"
+
+//==============================================================================
+/*
+    Close-up of the waveform around the playhead, which stays in the middle
+    while the track scrolls past. Each column is coloured by the energy of the
+    low (red), mid (green) and high (blue) bands of the track there.
+
+    It draws from the same waveform as the overview (nothing is decoded), a
+    bin or two per column, and columns stay on whole pixels of the track so
+    the picture does not shimmer as it scrolls.
+*/
+class ScrollingWaveformDisplay  : public juce::Component,
+                                  public juce::ChangeListener
+{
+public:
+    ScrollingWaveformDisplay(WaveformCache& cacheToUse);
+    ~ScrollingWaveformDisplay() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    //Virtual pure functions from ChangeListener
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    //Receive URL of a chosen track
+    void loadURL(juce::URL audioURL);
+
+    //Set the position of the playhead in the track (repaints only when the view moves by a pixel)
+    void setPositionInSeconds(double seconds);
+
+    //Seconds of the track either side of the playhead
+    static constexpr double secondsEachSide = 3.0;
+
+private:
+    //Track samples per pixel at the current width
+    double getSamplesPerPixel() const;
+
+    WaveformCache& waveformCache;
+    juce::URL trackURL;
+    TrackWaveform::Ptr waveform;
+    //The waveform cache could not analyse the track
+    bool analysisFailed = false;
+
+    //The track pixel under the playhead
+    juce::int64 playheadPixel = 0;
+    double positionInSeconds = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScrollingWaveformDisplay)
+};
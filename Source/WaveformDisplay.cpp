@@ -1,96 +1,205 @@
-/*
-  ==============================================================================
-
-    WaveformDisplay.cpp
-    Created: 29 Jul 2022 6:04:23pm
-    Author:  Api Rich
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "WaveformDisplay.h"
-
-//==============================================================================
-WaveformDisplay::WaveformDisplay(juce::AudioFormatManager& formatManagerToUse,
-                                 juce::AudioThumbnailCache& cacheToUse) : audioThumb(1000, formatManagerToUse, cacheToUse),
-                                                                          fileLoaded(false),
-                                                                          position(0)
-{
-    audioThumb.addChangeListener(this);
-}
-
-WaveformDisplay::~WaveformDisplay()
-{
-}
-
-void WaveformDisplay::paint (juce::Graphics& g)
-{
-    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
-
-    //Set background color of the whole waveform component
-    g.fillAll(juce::Colours::black);
-
-    //Set color of the waveform
-    g.setColour (juce::Colours::darkturquoise);
-
-    if(fileLoaded)   //If a chosen file has been loaded
-    {
-        audioThumb.drawChannel(g,
-                               getLocalBounds(),
-                               0,
-                               audioThumb.getTotalLength(),
-                               0,
-                               1.0f);
-        g.setColour(juce::Colours::darkred);
-        g.fillRect(position * getWidth(), 0, 2, getHeight());
-    }
-    else   //If there is no chosen file or load failed
-    {
-        g.setFont(20.0f);
-        g.drawFittedText("File not loaded... \nPlease selected track from the library!", getLocalBounds(), juce::Justification::centred, true);   // draw some placeholder text
-    }
-  
-}
-
-void WaveformDisplay::resized()
-{
-    // This method is where you should set the bounds of any child
-    // components that your component contains..
-
-}
-
-void WaveformDisplay::changeListenerCallback(juce::ChangeBroadcaster* source)
-{
-    //Repaint if there is any change
-    repaint();
-}
-
-
-void WaveformDisplay::loadURL(juce::URL audioURL)
-{
-    //Clear previous waveform
-    audioThumb.clear();
-
-    //Set new waveform for a chosen track
-    fileLoaded = audioThumb.setSource(new juce::URLInputSource(audioURL));
-
-    if(fileLoaded)
-    {
-        std::cout << "wfd: loaded!" << std::endl;
-    }
-    else
-    {
-        std::cout << "wfd: not loaded" << std::endl;
-    }
-}
-
-void WaveformDisplay::setPositionRelative(double pos)
-{
-    //Repaint when there is change on the chosen track (new position of the playing chosen track)
-    if (pos != position)
-    {
-        position = pos;
-        repaint();
-    }
-}
+/*
+  ==============================================================================
+
+    WaveformDisplay.cpp
+    Created: 29 Jul 2022 6:04:23pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "WaveformDisplay.h"
+
+//==============================================================================
+WaveformDisplay::WaveformDisplay(WaveformCache& cacheToUse) : waveformCache(cacheToUse),
+                                                              fileLoaded(false),
+                                                              position(0)
+{
+    waveformCache.addChangeListener(this);
+}
+
+WaveformDisplay::~WaveformDisplay()
+{
+    waveformCache.removeChangeListener(this);
+}
+
+void WaveformDisplay::paint (juce::Graphics& g)
+{
+    OTODESKS_PROFILE_SCOPE("WaveformDisplay::paint");
+
+    //The body is drawn again only for a new track, waveform, size or screen scale
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!body.isValid() || scale != bodyScale
+        || body.getWidth() != juce::roundToInt(getWidth() * scale) || body.getHeight() != juce::roundToInt(getHeight() * scale))
+    {
+        renderBody(scale);
+    }
+
+    if (body.isValid())
+    {
+        g.drawImageTransformed(body, juce::AffineTransform::scale(1.0f / bodyScale));
+    }
+
+    if(fileLoaded)   //If a chosen file has been loaded
+    {
+        //Loop region (brighter while it is playing), or just its in point
+        if (loopIn >= 0)
+        {
+            g.setColour(juce::Colours::orange.withAlpha(loopActive ? 0.35f : 0.15f));
+            if (loopOut > loopIn)
+            {
+                g.fillRect((float) (loopIn * getWidth()), 0.0f, (float) ((loopOut - loopIn) * getWidth()), (float) getHeight());
+            }
+            g.setColour(juce::Colours::orange);
+            g.fillRect((float) (loopIn * getWidth()), 0.0f, 1.0f, (float) getHeight());
+        }
+
+        g.setColour(juce::Colours::darkred);
+        g.fillRect(getPlayheadX(position), 0, playheadWidth, getHeight());
+    }
+}
+
+void WaveformDisplay::renderBody(float scale)
+{
+    OTODESKS_PROFILE_SCOPE("WaveformDisplay::renderBody");
+
+    bodyScale = scale;
+    int width = juce::roundToInt(getWidth() * scale);
+    int height = juce::roundToInt(getHeight() * scale);
+    if (width <= 0 || height <= 0)
+    {
+        body = {};
+        return;
+    }
+
+    //Drawn in physical pixels, so it stays sharp on high resolution screens
+    body = juce::Image(juce::Image::RGB, width, height, false);
+    juce::Graphics g(body);
+
+    //Set background color of the whole waveform component
+    g.fillAll(juce::Colours::black);
+
+    //Set color of the waveform
+    g.setColour (juce::Colours::darkturquoise);
+
+    if(fileLoaded)   //If a chosen file has been loaded
+    {
+        if (waveform != nullptr)
+        {
+            //A column per pixel from the level nearest the zoom, peaks dark and RMS bright
+            double samplesPerPixel = (double) waveform->getLengthInSamples() / width;
+            int level = waveform->getLevelFor(samplesPerPixel);
+            float centre = height * 0.5f;
+            float peakScale = centre / 127.0f;
+            for (int x = 0; x < width; ++x)
+            {
+                auto bin = waveform->getRange(level, (juce::int64) (x * samplesPerPixel), (juce::int64) ((x + 1) * samplesPerPixel));
+
+                g.setColour(juce::Colours::darkturquoise);
+                g.drawVerticalLine(x, centre - bin.max * peakScale, centre - bin.min * peakScale + 1.0f);
+
+                float rms = bin.rms * (centre / 255.0f);
+                g.setColour(juce::Colours::paleturquoise);
+                g.drawVerticalLine(x, centre - rms, centre + rms + 1.0f);
+            }
+        }
+        else   //Still being analysed, or could not be
+        {
+            g.addTransform(juce::AffineTransform::scale(scale));
+            g.setFont(14.0f);
+            g.drawFittedText(analysisFailed ? "Cannot analyse this track" : "Analysing...", getLocalBounds(), juce::Justification::centred, 1);
+        }
+    }
+    else   //If there is no chosen file or load failed
+    {
+        g.addTransform(juce::AffineTransform::scale(scale));
+        g.setFont(20.0f);
+        g.drawFittedText("File not loaded... \nPlease selected track from the library!", getLocalBounds(), juce::Justification::centred, true);   // draw some placeholder text
+    }
+}
+
+int WaveformDisplay::getPlayheadX(double pos) const
+{
+    return (int) (pos * getWidth());
+}
+
+void WaveformDisplay::resized()
+{
+    //The body is drawn again at the new size
+    body = {};
+}
+
+void WaveformDisplay::mouseDown(const juce::MouseEvent& event)
+{
+    //Only a loaded track can be seeked
+    if (fileLoaded && onSeek != nullptr && getWidth() > 0)
+    {
+        onSeek(juce::jlimit(0.0, 1.0, (double) event.x / getWidth()));
+    }
+}
+
+void WaveformDisplay::mouseDrag(const juce::MouseEvent& event)
+{
+    mouseDown(event);
+}
+
+void WaveformDisplay::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    //A waveform has become ready (or failed), which may be the one of the chosen track
+    if (fileLoaded && waveform == nullptr && !analysisFailed)
+    {
+        waveform = waveformCache.get(trackURL);
+        analysisFailed = waveform == nullptr && waveformCache.hasFailed(trackURL);
+        if (waveform != nullptr || analysisFailed)
+        {
+            body = {};
+            repaint();
+        }
+    }
+}
+
+
+void WaveformDisplay::loadURL(juce::URL audioURL)
+{
+    //Set new waveform for a chosen track (read from the cache, or analysed in the background)
+    trackURL = audioURL;
+    fileLoaded = !audioURL.isEmpty();
+    waveform = waveformCache.get(audioURL);
+    analysisFailed = fileLoaded && waveform == nullptr && waveformCache.hasFailed(audioURL);
+    body = {};
+    repaint();
+
+    if(fileLoaded)
+    {
+        std::cout << "wfd: loaded!" << std::endl;
+    }
+    else
+    {
+        std::cout << "wfd: not loaded" << std::endl;
+    }
+}
+
+void WaveformDisplay::setPositionRelative(double pos)
+{
+    //Repaint only the strips the playhead leaves and moves to, when it moves by a pixel or more
+    int oldX = getPlayheadX(position);
+    int newX = getPlayheadX(pos);
+    position = pos;
+    if (newX != oldX && fileLoaded)
+    {
+        repaint(oldX, 0, playheadWidth, getHeight());
+        repaint(newX, 0, playheadWidth, getHeight());
+    }
+}
+
+void WaveformDisplay::setLoopRelative(double in, double out, bool active)
+{
+    if (in != loopIn || out != loopOut || active != loopActive)
+    {
+        loopIn = in;
+        loopOut = out;
+        loopActive = active;
+        repaint();
+    }
+}
@@ -1,48 +1,77 @@
-/*
-  ==============================================================================
-
-    WaveformDisplay.h
-    Created: 29 Jul 2022 6:04:23pm
-    Author:  Api Rich
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-
-//==============================================================================
-/*
-*/
-class WaveformDisplay  : public juce::Component,
-                         public juce::ChangeListener
-{
-public:
-    WaveformDisplay(juce::AudioFormatManager& formatManagerToUse,
-                    juce::AudioThumbnailCache& cacheToUse);
-    ~WaveformDisplay() override;
-
-    void paint (juce::Graphics&) override;
-    void resized() override;
-
-    //Virtual pure functions from ChangeListener
-    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
-
-    //Receive URL of a chosen track and set it as a source for waveformDisplay
-    void loadURL(juce::URL audioURL);
-
-    //Set the relative position of the playhead
-    void setPositionRelative(double pos);
-
-private:
-    //Waveform variable
-    juce::AudioThumbnail audioThumb;
-
-    //Bool to check if a chosen file has been loaded yet
-    bool fileLoaded;
-
-    //Bool for new position of the playhead of the waveform
-    double position;
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformDisplay)
-};
+/*
+  ==============================================================================
+
+    WaveformDisplay.h
+    Created: 29 Jul 2022 6:04:23pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Engine/AudioProfiler.h"
+#include "Engine/WaveformCache.h"
+
+//==============================================================================
+/*
+*/
+class WaveformDisplay  : public juce::Component,
+                         public juce::ChangeListener
+{
+public:
+    WaveformDisplay(WaveformCache& cacheToUse);
+    ~WaveformDisplay() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    //Clicking or dragging on the waveform seeks there
+    void mouseDown(const juce::MouseEvent& event) override;
+    void mouseDrag(const juce::MouseEvent& event) override;
+
+    //Virtual pure functions from ChangeListener
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    //Receive URL of a chosen track and set it as a source for waveformDisplay
+    void loadURL(juce::URL audioURL);
+
+    //Set the relative position of the playhead (cheap, it can be called at the display refresh rate)
+    void setPositionRelative(double pos);
+    //Called with the relative position the waveform was clicked at
+    std::function<void(double)> onSeek;
+
+    //Set the relative loop in and out points (negative when not set), and whether the loop is playing
+    void setLoopRelative(double in, double out, bool active);
+
+private:
+    //Draw the background and the waveform into the body image, at a number of physical pixels per pixel
+    void renderBody(float scale);
+    //Left edge of the playhead at a relative position
+    int getPlayheadX(double pos) const;
+
+    //Waveforms of the tracks, and the one of the chosen track (nullptr until it has been analysed)
+    WaveformCache& waveformCache;
+    juce::URL trackURL;
+    TrackWaveform::Ptr waveform;
+
+    //The waveform drawn once (null until the next paint after a change), the loop and playhead go on top
+    juce::Image body;
+    float bodyScale = 1.0f;
+
+    //Bool to check if a chosen file has been loaded yet
+    bool fileLoaded;
+    //Bool for a chosen file the waveform cache could not analyse
+    bool analysisFailed = false;
+
+    //Bool for new position of the playhead of the waveform
+    double position;
+    static constexpr int playheadWidth = 2;
+
+    //Relative loop points, shaded over the waveform
+    double loopIn = -1;
+    double loopOut = -1;
+    bool loopActive = false;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformDisplay)
+};
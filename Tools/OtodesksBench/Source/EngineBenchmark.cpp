@@ -0,0 +1,492 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+    Created: 24 Sep 2022 2:37:05pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "EngineBenchmark.h"
+
+namespace
+{
+    //Length (in secs) and sample rate of the test tracks
+    constexpr double trackLength = 30.0;
+    constexpr double trackRate = 44100.0;
+
+    double ticksToSeconds(juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks);
+    }
+
+    void waitUntilLoaded(DJAudioPlayer& player)
+    {
+        while (player.isLoading())
+        {
+            juce::Thread::yield();
+        }
+        player.dispatchTransportEvents();
+    }
+}
+
+//==============================================================================
+EngineBenchmark::EngineBenchmark()
+{
+    formatManager.registerBasicFormats();
+    readAheadThread.startThread();
+}
+
+EngineBenchmark::~EngineBenchmark()
+{
+    readAheadThread.stopThread(1000);
+}
+
+juce::String EngineBenchmark::prepare(const juce::File& workDirectory)
+{
+    if (!workDirectory.createDirectory())
+    {
+        return "Could not create " + workDirectory.getFullPathName();
+    }
+
+    //Noise and two tones, so the filters and the interpolation have something to chew on
+    int numSamples = (int) (trackLength * trackRate);
+    juce::AudioBuffer<float> signal(2, numSamples);
+    juce::Random random(1);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        double t = i / trackRate;
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            signal.setSample(ch, i, (float) (0.1 * (random.nextDouble() * 2.0 - 1.0)
+                                             + 0.3 * std::sin(2.0 * juce::MathConstants<double>::pi * 110.0 * t + ch)
+                                             + 0.2 * std::sin(2.0 * juce::MathConstants<double>::pi * 3520.0 * t)));
+        }
+    }
+
+    //One test track per format that can write (read-only formats are skipped)
+    for (int i = 0; i < formatManager.getNumKnownFormats(); ++i)
+    {
+        auto* format = formatManager.getKnownFormat(i);
+        auto extension = format->getFileExtensions()[0];
+        auto bitDepths = format->getPossibleBitDepths();
+        if (extension.isEmpty() || !format->canDoStereo() || bitDepths.isEmpty())
+        {
+            continue;
+        }
+
+        auto file = workDirectory.getChildFile("bench" + extension);
+        file.deleteFile();
+        std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+        if (stream == nullptr)
+        {
+            continue;
+        }
+
+        int qualityIndex = format->getQualityOptions().size() / 2;
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), trackRate, 2,
+                                                                                bitDepths.contains(16) ? 16 : bitDepths[0],
+                                                                                {}, qualityIndex));
+        if (writer == nullptr)
+        {
+            continue;
+        }
+        //The writer owns the stream now
+        stream.release();
+
+        writer->writeFromAudioSampleBuffer(signal, 0, numSamples);
+        writer.reset();
+
+        trackFiles.add(file);
+        if (extension == ".wav")
+        {
+            playTrack = file;
+        }
+    }
+
+    if (!playTrack.existsAsFile())
+    {
+        return "Could not write the WAV test track.";
+    }
+    return {};
+}
+
+void EngineBenchmark::run(bool quick, const juce::String& filter)
+{
+    quickRun = quick;
+    nameFilter = filter;
+
+    benchmarkFormats();
+    benchmarkLoad();
+
+    //The render kernels play from memory, so the disk is not part of the numbers
+    juce::URL playURL(playTrack);
+    trackCache.prefetch(playURL);
+    while (trackCache.find(playURL) == nullptr)
+    {
+        juce::Thread::sleep(10);
+    }
+
+    std::vector<int> blockSizes = quick ? std::vector<int>{ 64, 512, 2048 }
+                                        : std::vector<int>{ 32, 64, 128, 256, 512, 1024, 2048 };
+    std::vector<double> sampleRates = quick ? std::vector<double>{ 44100.0, 96000.0 }
+                                            : std::vector<double>{ 44100.0, 48000.0, 88200.0, 96000.0 };
+
+    for (auto sampleRate : sampleRates)
+    {
+        for (auto blockSize : blockSizes)
+        {
+            benchmarkPlayer(blockSize, sampleRate);
+            benchmarkMix(blockSize, sampleRate);
+        }
+    }
+}
+
+const std::vector<EngineBenchmark::Result>& EngineBenchmark::getResults() const
+{
+    return results;
+}
+
+//==============================================================================
+void EngineBenchmark::benchmarkFormats()
+{
+    int numRuns = quickRun ? 1 : 3;
+
+    for (auto& file : trackFiles)
+    {
+        auto extension = file.getFileExtension().substring(1);
+
+        //Open: create a reader (headers, seek tables), best of 20
+        auto openName = "open/" + extension;
+        if (isSelected(openName))
+        {
+            double best = std::numeric_limits<double>::max();
+            for (int i = 0; i < 20; ++i)
+            {
+                auto startTicks = juce::Time::getHighResolutionTicks();
+                std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+                best = juce::jmin(best, ticksToSeconds(juce::Time::getHighResolutionTicks() - startTicks));
+            }
+            add(openName, "ms", best * 1000.0);
+        }
+
+        //Decode: read the whole file in blocks, as the decoded track cache does
+        auto decodeName = "decode/" + extension;
+        if (isSelected(decodeName))
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+            if (reader == nullptr || reader->lengthInSamples <= 0)
+            {
+                continue;
+            }
+
+            juce::AudioBuffer<float> block(2, 4096);
+            double best = std::numeric_limits<double>::max();
+            for (int run = 0; run < numRuns; ++run)
+            {
+                auto startTicks = juce::Time::getHighResolutionTicks();
+                for (juce::int64 position = 0; position < reader->lengthInSamples; position += block.getNumSamples())
+                {
+                    int numSamples = (int) juce::jmin((juce::int64) block.getNumSamples(), reader->lengthInSamples - position);
+                    reader->read(&block, 0, numSamples, position, true, true);
+                }
+                best = juce::jmin(best, ticksToSeconds(juce::Time::getHighResolutionTicks() - startTicks));
+            }
+            add(decodeName, "ns/sample", best * 1.0e9 / (double) reader->lengthInSamples);
+        }
+    }
+}
+
+void EngineBenchmark::benchmarkLoad()
+{
+    int numLoads = quickRun ? 3 : 10;
+
+    //Streamed: open and pre-roll through read-ahead (a cache with no budget never keeps the track)
+    {
+        DecodedTrackCache noCache{ formatManager, 0 };
+        DJAudioPlayer player(formatManager, readAheadThread, noCache);
+        player.prepareToPlay(512, trackRate);
+        player.setReadAheadSize(65536);
+
+        for (auto& file : trackFiles)
+        {
+            auto name = "load/" + file.getFileExtension().substring(1);
+            if (!isSelected(name))
+            {
+                continue;
+            }
+
+            double best = std::numeric_limits<double>::max();
+            for (int i = 0; i < numLoads; ++i)
+            {
+                auto startTicks = juce::Time::getHighResolutionTicks();
+                player.loadURL(juce::URL(file), false);
+                waitUntilLoaded(player);
+                best = juce::jmin(best, ticksToSeconds(juce::Time::getHighResolutionTicks() - startTicks));
+            }
+            add(name, "ms", best * 1000.0);
+        }
+        player.releaseResources();
+    }
+
+    //From the decoded track cache (a deck switching between decked tracks)
+    if (isSelected("load/cache"))
+    {
+        juce::URL playURL(playTrack);
+        trackCache.prefetch(playURL);
+        while (trackCache.find(playURL) == nullptr)
+        {
+            juce::Thread::sleep(10);
+        }
+
+        DJAudioPlayer player(formatManager, readAheadThread, trackCache);
+        player.prepareToPlay(512, trackRate);
+
+        double best = std::numeric_limits<double>::max();
+        for (int i = 0; i < numLoads; ++i)
+        {
+            auto startTicks = juce::Time::getHighResolutionTicks();
+            player.loadURL(playURL, false);
+            waitUntilLoaded(player);
+            best = juce::jmin(best, ticksToSeconds(juce::Time::getHighResolutionTicks() - startTicks));
+        }
+        add("load/cache", "ms", best * 1000.0);
+        player.releaseResources();
+    }
+}
+
+void EngineBenchmark::benchmarkPlayer(int blockSize, double sampleRate)
+{
+    struct Kernel
+    {
+        const char* name;
+        double speed;
+        bool lowPass, highPass, bandPass, keyLock, isolator;
+        ResamplingKernel::Quality quality;
+    };
+
+    //Speeds cover slowing down, pitch riding around 1 and doubling (the transport resamples all of them),
+    //at the default (medium) quality and at the other two
+    const auto low = ResamplingKernel::lowQuality;
+    const auto medium = ResamplingKernel::mediumQuality;
+    const auto high = ResamplingKernel::highQuality;
+    const Kernel kernels[] = { { "play",            1.0,  false, false, false, false, false, medium },
+                               { "speed-0.5",       0.5,  false, false, false, false, false, medium },
+                               { "speed-0.94",      0.94, false, false, false, false, false, medium },
+                               { "speed-1.06",      1.06, false, false, false, false, false, medium },
+                               { "speed-2",         2.0,  false, false, false, false, false, medium },
+                               { "speed-1.06-low",  1.06, false, false, false, false, false, low },
+                               { "speed-1.06-high", 1.06, false, false, false, false, false, high },
+                               { "speed-2-low",     2.0,  false, false, false, false, false, low },
+                               { "speed-2-high",    2.0,  false, false, false, false, false, high },
+                               { "lowPass",         1.0,  true,  false, false, false, false, medium },
+                               { "highPass",        1.0,  false, true,  false, false, false, medium },
+                               { "bandPass",        1.0,  false, false, true,  false, false, medium },
+                               { "isolator",        1.0,  false, false, false, false, true,  medium },
+                               { "keyLock-0.94",    0.94, false, false, false, true,  false, medium },
+                               { "keyLock-1.06",    1.06, false, false, false, true,  false, medium } };
+
+    auto suffix = "/" + juce::String(blockSize) + "/" + juce::String((int) sampleRate);
+
+    for (auto& kernel : kernels)
+    {
+        auto name = kernel.name + suffix;
+        if (!isSelected(name))
+        {
+            continue;
+        }
+
+        DJAudioPlayer player(formatManager, readAheadThread, trackCache);
+        player.prepareToPlay(blockSize, sampleRate);
+        if (!startPlayer(player))
+        {
+            continue;
+        }
+
+        player.setSpeed(kernel.speed);
+        player.setResamplingQuality(kernel.quality);
+        player.setKeyLock(kernel.keyLock);
+        if (kernel.lowPass || kernel.highPass || kernel.bandPass)
+        {
+            player.setPass(1000.0, 0.7, kernel.lowPass, kernel.highPass, kernel.bandPass);
+        }
+        if (kernel.isolator)
+        {
+            player.setEQ(0.0, 1.0, 1.5);
+        }
+
+        add(name, "ns/sample", timeRender(player, { &player }, blockSize, sampleRate));
+        player.releaseResources();
+    }
+}
+
+void EngineBenchmark::benchmarkMix(int blockSize, double sampleRate)
+{
+    auto suffix = "/" + juce::String(blockSize) + "/" + juce::String((int) sampleRate);
+
+    for (int numDecks = 2; numDecks <= DeckRegistry::maxDecks; numDecks += 2)
+    {
+        auto name = "mix-" + juce::String(numDecks) + suffix;
+        if (!isSelected(name))
+        {
+            continue;
+        }
+
+        //Decks rendered one after the other on this thread (the mixing itself, not the render pool)
+        DeckMixer mixer;
+        DeckRegistry decks{ formatManager, readAheadThread, trackCache, mixer };
+        decks.setReadAheadSize(0);
+        mixer.prepareToPlay(blockSize, sampleRate);
+
+        std::vector<DJAudioPlayer*> players;
+        for (int i = 0; i < numDecks; ++i)
+        {
+            auto* player = decks.addDeck(i % 2 == 0 ? DeckMixer::sideA : DeckMixer::sideB);
+            if (player != nullptr && startPlayer(*player))
+            {
+                players.push_back(player);
+            }
+        }
+
+        add(name, "ns/sample", timeRender(mixer, players, blockSize, sampleRate));
+        mixer.releaseResources();
+    }
+}
+
+//==============================================================================
+bool EngineBenchmark::startPlayer(DJAudioPlayer& player)
+{
+    player.setReadAheadSize(0);
+    player.loadURL(juce::URL(playTrack), true);
+    waitUntilLoaded(player);
+    player.play();
+    return player.getLengthInSeconds() > 0;
+}
+
+double EngineBenchmark::timeRender(juce::AudioSource& source, const std::vector<DJAudioPlayer*>& players, int blockSize, double sampleRate)
+{
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::AudioSourceChannelInfo info(&buffer, 0, blockSize);
+
+    auto numBlocks = [&](double seconds) { return juce::jmax(1, (int) (seconds * sampleRate / blockSize)); };
+
+    //Hand the transport events over (nobody listens), so the FIFOs never fill up
+    auto dispatch = [&players]()
+    {
+        for (auto* player : players)
+        {
+            player->dispatchTransportEvents();
+        }
+    };
+
+    //Warm up: caches, branch predictors, and parameter ramps that have to settle
+    for (int i = 0; i < numBlocks(0.5); ++i)
+    {
+        source.getNextAudioBlock(info);
+        dispatch();
+    }
+
+    int numRuns = quickRun ? 1 : 3;
+    int blocksPerRun = numBlocks(quickRun ? 2.0 : 8.0);
+    juce::int64 best = std::numeric_limits<juce::int64>::max();
+
+    for (int run = 0; run < numRuns; ++run)
+    {
+        //Only the render call is timed, the event hand-over is not part of the kernel
+        juce::int64 ticks = 0;
+        for (int i = 0; i < blocksPerRun; ++i)
+        {
+            auto startTicks = juce::Time::getHighResolutionTicks();
+            source.getNextAudioBlock(info);
+            ticks += juce::Time::getHighResolutionTicks() - startTicks;
+            dispatch();
+        }
+        best = juce::jmin(best, ticks);
+    }
+
+    return ticksToSeconds(best) * 1.0e9 / ((double) blocksPerRun * blockSize);
+}
+
+bool EngineBenchmark::isSelected(const juce::String& name) const
+{
+    return nameFilter.isEmpty() || name.contains(nameFilter);
+}
+
+void EngineBenchmark::add(const juce::String& name, const juce::String& unit, double value)
+{
+    results.push_back({ name, unit, value });
+    std::cout << name.paddedRight(' ', 28) << juce::String(value, 3).paddedLeft(' ', 12) << " " << unit << std::endl;
+}
+
+//==============================================================================
+juce::var EngineBenchmark::toJSON(double threshold) const
+{
+    auto* machine = new juce::DynamicObject();
+    machine->setProperty("cpu", juce::SystemStats::getCpuModel());
+    machine->setProperty("cores", juce::SystemStats::getNumCpus());
+    machine->setProperty("os", juce::SystemStats::getOperatingSystemName());
+
+    juce::Array<juce::var> resultList;
+    for (auto& result : results)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("name", result.name);
+        entry->setProperty("unit", result.unit);
+        entry->setProperty("value", result.value);
+        resultList.add(juce::var(entry));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("version", 1);
+    root->setProperty("machine", juce::var(machine));
+    root->setProperty("threshold", threshold);
+    root->setProperty("results", resultList);
+    return juce::var(root);
+}
+
+int EngineBenchmark::compare(const juce::var& results, const juce::var& baseline, double threshold)
+{
+    std::map<juce::String, double> base;
+    if (auto* baselineList = baseline.getProperty("results", {}).getArray())
+    {
+        for (auto& entry : *baselineList)
+        {
+            base[entry.getProperty("name", "").toString()] = entry.getProperty("value", 0.0);
+        }
+    }
+
+    //Every kernel that ran is checked (kernels of the baseline that did not run, filtered out or a format this build lacks, are not)
+    int numRegressions = 0;
+    int numMissing = 0;
+    int numCompared = 0;
+    if (auto* resultList = results.getProperty("results", {}).getArray())
+    {
+        for (auto& result : *resultList)
+        {
+            auto name = result.getProperty("name", "").toString();
+            double value = result.getProperty("value", 0.0);
+            auto found = base.find(name);
+            if (found == base.end() || found->second <= 0)   //A new kernel, or a baseline that was never written: fails until it is
+            {
+                ++numMissing;
+                std::cout << "NO BASELINE " << name << ": " << value << std::endl;
+                continue;
+            }
+
+            ++numCompared;
+            double change = value / found->second - 1.0;
+            if (change > threshold)
+            {
+                ++numRegressions;
+                std::cout << "REGRESSION " << name << ": " << found->second << " -> " << value << " ("
+                          << juce::String(change * 100.0, 1) << "%)" << std::endl;
+            }
+        }
+    }
+
+    std::cout << "EngineBenchmark::compare " << numCompared << " kernels against the baseline, " << numRegressions
+              << " slower by more than " << juce::String(threshold * 100.0, 0) << "%, " << numMissing
+              << " with no baseline" << std::endl;
+    return numRegressions + numMissing;
+}
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.h
+    Created: 24 Sep 2022 2:37:05pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include "Engine/DJAudioPlayer.h"
+#include "Engine/DeckMixer.h"
+#include "Engine/DeckRegistry.h"
+
+//==============================================================================
+/*
+    Times the kernels of the audio engine, with no audio device and no message
+    loop.
+
+    Every result is "lower is better" and is named kernel/blockSize/sampleRate
+    (or kernel/format for the file kernels):
+
+    - open/<format>, load/<format>, load/cache: ms to open a file or to load a track into a deck
+    - decode/<format>: ns to decode one stereo sample frame
+    - play, speed-<ratio>[-low|-high], lowPass, highPass, bandPass, isolator,
+      keyLock-<ratio>, mix-<decks>:
+      ns of render time per output sample frame (the best of a few runs), at
+      the medium resampling quality unless the name says otherwise
+
+    Test tracks are generated (30 secs of noise and tones at 44.1 kHz) in every
+    format the format manager can write, so the numbers do not depend on a
+    music collection.
+*/
+class EngineBenchmark
+{
+public:
+    struct Result
+    {
+        juce::String name;
+        juce::String unit;
+        double value;
+    };
+
+    EngineBenchmark();
+    ~EngineBenchmark();
+
+    //Write the test tracks into workDirectory, returns an error message (empty when it is fine)
+    juce::String prepare(const juce::File& workDirectory);
+    //Run every kernel whose name contains filter (all of them when it is empty), quick runs a smaller matrix
+    void run(bool quick, const juce::String& filter);
+
+    const std::vector<Result>& getResults() const;
+    //Results as JSON: { "version", "machine", "threshold", "results": [ { "name", "unit", "value" } ] }
+    juce::var toJSON(double threshold) const;
+
+    //Compare results against a baseline (same JSON), print every kernel slower than baseline * (1 + threshold)
+    //and every kernel the baseline has no number for, returns the number of them
+    static int compare(const juce::var& results, const juce::var& baseline, double threshold);
+
+private:
+    //File kernels
+    void benchmarkFormats();
+    void benchmarkLoad();
+    //One deck, and several decks through the mixer, at a block size and device rate
+    void benchmarkPlayer(int blockSize, double sampleRate);
+    void benchmarkMix(int blockSize, double sampleRate);
+
+    //Load the test track (from the cache) into a player and start it
+    bool startPlayer(DJAudioPlayer& player);
+    //Render source in blocks for a while, returns the best ns per output sample of a few runs
+    double timeRender(juce::AudioSource& source, const std::vector<DJAudioPlayer*>& players, int blockSize, double sampleRate);
+
+    bool isSelected(const juce::String& name) const;
+    void add(const juce::String& name, const juce::String& unit, double value);
+
+    juce::AudioFormatManager formatManager;
+    juce::TimeSliceThread readAheadThread{ "Bench read-ahead" };
+    DecodedTrackCache trackCache{ formatManager, (size_t) 1024 * 1024 * 1024 };
+
+    //Test track of each format that could be written, the WAV one is played by the render kernels
+    juce::Array<juce::File> trackFiles;
+    juce::File playTrack;
+
+    bool quickRun = false;
+    juce::String nameFilter;
+    std::vector<Result> results;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EngineBenchmark)
+};
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for the Otodesks engine benchmark.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "EngineBenchmark.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: OtodesksBench [--quick] [--filter text] [--output results.json]" << std::endl
+                  << "                     [--baseline baseline.json] [--threshold 0.25] [--write-baseline baseline.json]" << std::endl
+                  << "Times the audio engine kernels and writes the results as JSON (lower is better)." << std::endl
+                  << "With --baseline, exits with 2 when a kernel is slower than the baseline by more than the threshold" << std::endl
+                  << "(taken from the baseline file unless --threshold is given), or has no number in the baseline." << std::endl;
+        return 0;
+    }
+
+    //The players use timers and async updates, they need a message manager (no message loop is run)
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+
+    juce::var baseline;
+    if (args.containsOption("--baseline"))
+    {
+        auto baselineFile = cwd.getChildFile(args.getValueForOption("--baseline"));
+        auto result = juce::JSON::parse(baselineFile.loadFileAsString(), baseline);
+        if (result.failed())
+        {
+            std::cerr << "OtodesksBench: could not read " << baselineFile.getFullPathName() << ": " << result.getErrorMessage() << std::endl;
+            return 1;
+        }
+    }
+
+    double threshold = args.containsOption("--threshold") ? args.getValueForOption("--threshold").getDoubleValue()
+                                                          : (double) baseline.getProperty("threshold", 0.25);
+
+    auto workDirectory = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("OtodesksBench");
+
+    int exitCode = 0;
+    {
+        EngineBenchmark benchmark;
+        auto error = benchmark.prepare(workDirectory);
+        if (error.isNotEmpty())
+        {
+            std::cerr << "OtodesksBench: " << error << std::endl;
+            return 1;
+        }
+
+        benchmark.run(args.containsOption("--quick"), args.getValueForOption("--filter"));
+        auto json = juce::JSON::toString(benchmark.toJSON(threshold));
+
+        for (auto option : { "--output", "--write-baseline" })
+        {
+            if (args.containsOption(option))
+            {
+                auto file = cwd.getChildFile(args.getValueForOption(option));
+                if (!file.replaceWithText(json))
+                {
+                    std::cerr << "OtodesksBench: could not write " << file.getFullPathName() << std::endl;
+                    exitCode = 1;
+                }
+            }
+        }
+
+        if (baseline.isObject() && EngineBenchmark::compare(benchmark.toJSON(threshold), baseline, threshold) > 0)
+        {
+            exitCode = 2;
+        }
+    }
+
+    workDirectory.deleteRecursively();
+    return exitCode;
+}
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for the Otodesks offline renderer.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SessionRenderer.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() < 2 || args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: OtodesksRender <session.json> <output.wav> [--threads N] [--trace trace.json]" << std::endl
+                  << "Renders a scripted Otodesks session to a WAV file as fast as the CPU allows." << std::endl
+                  << "--trace records the time of every render stage as Chrome trace JSON." << std::endl;
+        return args.containsOption("--help|-h") ? 0 : 1;
+    }
+
+    //The engine uses timers and async updates, they need a message manager (no message loop is run)
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    int numThreads = args.getValueForOption("--threads").getIntValue();
+
+    auto sessionFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[0].text);
+    auto outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[1].text);
+
+    bool tracing = args.containsOption("--trace");
+    auto traceFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--trace"));
+
+    SessionRenderer renderer;
+    auto error = renderer.loadSession(sessionFile);
+    if (error.isEmpty())
+    {
+        if (tracing)
+        {
+            AudioProfiler::start();
+        }
+
+        error = renderer.render(outputFile, numThreads);
+
+        if (tracing)
+        {
+            AudioProfiler::stop();
+            if (!AudioProfiler::exportTrace(traceFile))
+            {
+                error = "Could not write " + traceFile.getFullPathName();
+            }
+        }
+    }
+
+    if (error.isNotEmpty())
+    {
+        std::cerr << "OtodesksRender: " << error << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
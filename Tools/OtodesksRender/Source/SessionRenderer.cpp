@@ -0,0 +1,430 @@
+/*
+  ==============================================================================
+
+    SessionRenderer.cpp
+    Created: 21 Sep 2022 4:12:50pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#include "SessionRenderer.h"
+
+SessionRenderer::SessionRenderer()
+{
+    formatManager.registerBasicFormats();
+    readAheadThread.startThread();
+
+    //Offline, the audio thread may wait on the disk: read straight from the file (or from the cache)
+    decks.setReadAheadSize(0);
+}
+
+SessionRenderer::~SessionRenderer()
+{
+    readAheadThread.stopThread(1000);
+}
+
+juce::String SessionRenderer::loadSession(const juce::File& sessionFile)
+{
+    juce::var session;
+    auto result = juce::JSON::parse(sessionFile.loadFileAsString(), session);
+    if (result.failed())
+    {
+        return "Could not read " + sessionFile.getFullPathName() + ": " + result.getErrorMessage();
+    }
+
+    sampleRate = session.getProperty("sampleRate", 44100.0);
+    blockSize = session.getProperty("blockSize", 256);
+    lengthInSeconds = session.getProperty("length", 0.0);
+    bitDepth = session.getProperty("bitDepth", 24);
+    if (sampleRate <= 0 || blockSize <= 0 || lengthInSeconds <= 0)
+    {
+        return "The session needs a positive sampleRate, blockSize and length.";
+    }
+
+    auto quality = session.getProperty("quality", "high").toString();
+    if (quality != "low" && quality != "medium" && quality != "high")
+    {
+        return "The session quality should be low, medium or high.";
+    }
+    decks.setResamplingQuality(quality == "low" ? ResamplingKernel::lowQuality
+                               : quality == "medium" ? ResamplingKernel::mediumQuality
+                               : ResamplingKernel::highQuality);
+
+    //Decks
+    if (auto* deckList = session.getProperty("decks", {}).getArray())
+    {
+        for (auto& deck : *deckList)
+        {
+            DeckSetup setup;
+            setup.track = sessionFile.getParentDirectory().getChildFile(deck.getProperty("track", "").toString());
+            setup.looping = deck.getProperty("looping", false);
+            setup.keyLock = deck.getProperty("keyLock", false);
+            setup.bpm = deck.getProperty("bpm", 120.0);
+
+            auto side = deck.getProperty("side", "").toString();
+            setup.side = side == "A" ? DeckMixer::sideA : side == "B" ? DeckMixer::sideB : DeckMixer::thru;
+
+            if (setup.bpm < 20 || setup.bpm > 300)
+            {
+                return "The bpm of " + setup.track.getFileName() + " should be between 20 and 300.";
+            }
+            if (!setup.track.existsAsFile())
+            {
+                return "No such track: " + setup.track.getFullPathName();
+            }
+            deckSetups.push_back(setup);
+        }
+    }
+    if (deckSetups.empty() || (int) deckSetups.size() > DeckRegistry::maxDecks)
+    {
+        return "The session needs between 1 and " + juce::String(DeckRegistry::maxDecks) + " decks.";
+    }
+    deckStates.resize(deckSetups.size());
+
+    //Events
+    if (auto* eventList = session.getProperty("events", {}).getArray())
+    {
+        for (auto& event : *eventList)
+        {
+            double time = event.getProperty("time", 0.0);
+            int deck = event.getProperty("deck", -1);
+            if (deck >= (int) deckSetups.size())
+            {
+                return "Event at " + juce::String(time) + " s is for a deck that does not exist.";
+            }
+
+            if (event.hasProperty("do"))   //Transport action, at its exact sample
+            {
+                auto action = event.getProperty("do", "").toString();
+                DeckTransport::Command command;
+                command.renderSample = (juce::int64) std::llround(time * sampleRate);
+                command.position = event.getProperty("position", 0.0);
+
+                if (action == "play")        command.type = DeckTransport::Command::play;
+                else if (action == "stop")   command.type = DeckTransport::Command::stop;
+                else if (action == "cue")    command.type = DeckTransport::Command::cue;
+                else if (action == "setCue") command.type = DeckTransport::Command::setCue;
+                else if (action == "jump")   command.type = DeckTransport::Command::jump;
+                else if (action == "loopIn")   command.type = DeckTransport::Command::loopIn;
+                else if (action == "loopOut")  command.type = DeckTransport::Command::loopOut;
+                else if (action == "beatLoop") command.type = DeckTransport::Command::loopLength;
+                else if (action == "reloop")   command.type = DeckTransport::Command::reloop;
+                else if (action == "exitLoop") command.type = DeckTransport::Command::exitLoop;
+                else
+                {
+                    return "Unknown action \"" + action + "\" at " + juce::String(time) + " s.";
+                }
+
+                if (deck < 0)
+                {
+                    return "Action at " + juce::String(time) + " s needs a deck.";
+                }
+                if (action == "beatLoop")   //Beats at the tempo of the deck, as the loop length in secs of the track
+                {
+                    double beats = event.getProperty("beats", 4.0);
+                    if (beats < 0.25 || beats > 32)
+                    {
+                        return "Beat loop at " + juce::String(time) + " s should be between 1/4 and 32 beats.";
+                    }
+                    command.position = beats * 60.0 / deckSetups[(size_t) deck].bpm;
+                }
+                commands.push_back({ deck, command });
+            }
+
+            if (event.hasProperty("set"))   //Parameter, possibly ramped
+            {
+                Ramp ramp;
+                ramp.startTime = time;
+                ramp.length = event.getProperty("ramp", 0.0);
+                ramp.deck = deck;
+                ramp.to = event.getProperty("to", 0.0);
+                ramp.filter = event.getProperty("filter", "").toString();
+
+                auto name = event.getProperty("set", "").toString();
+                if (!parseParameter(name, ramp.parameter))
+                {
+                    return "Unknown parameter \"" + name + "\" at " + juce::String(time) + " s.";
+                }
+
+                bool mixerParameter = ramp.parameter == crossfaderParameter || ramp.parameter == masterParameter;
+                if (mixerParameter != (deck < 0))
+                {
+                    return "Parameter \"" + name + "\" at " + juce::String(time) + " s is for "
+                           + (mixerParameter ? "the mixer, not a deck." : "a deck.");
+                }
+                if (ramp.filter.isNotEmpty() && deck < 0)   //The filter type is set on the deck the ramp is for
+                {
+                    return "Filter at " + juce::String(time) + " s needs a deck.";
+                }
+                ramps.push_back(ramp);
+            }
+        }
+    }
+
+    //Ramps start in time order (ramps of the same time in script order)
+    std::stable_sort(ramps.begin(), ramps.end(), [](const Ramp& a, const Ramp& b) { return a.startTime < b.startTime; });
+    return {};
+}
+
+juce::String SessionRenderer::loadDecks()
+{
+    //Decode every track into memory first (on the cache's pool, in parallel)
+    for (auto& setup : deckSetups)
+    {
+        trackCache.prefetch(juce::URL(setup.track));
+    }
+
+    for (auto& setup : deckSetups)
+    {
+        auto* player = decks.addDeck(setup.side);
+        if (player == nullptr)
+        {
+            return "Could not create a deck for " + setup.track.getFileName();
+        }
+
+        //Wait for the decode (a track that cannot be decoded in memory is streamed from the file)
+        juce::URL trackURL(setup.track);
+        for (int waited = 0; trackCache.find(trackURL) == nullptr && waited < 60000; waited += 10)
+        {
+            juce::Thread::sleep(10);
+        }
+
+        player->setKeyLock(setup.keyLock);
+        player->setBPM(setup.bpm);
+        player->loadURL(trackURL, setup.looping);
+        while (player->isLoading())
+        {
+            juce::Thread::sleep(1);
+        }
+
+        //A track that could not be opened would only render as silence
+        if (player->getLengthInSeconds() <= 0)
+        {
+            return "Could not load " + setup.track.getFullPathName();
+        }
+    }
+
+    return {};
+}
+
+juce::String SessionRenderer::render(const juce::File& outputFile, int numThreads)
+{
+    mixer.prepareToPlay(blockSize, sampleRate);
+
+    auto error = loadDecks();
+    if (error.isNotEmpty())
+    {
+        return error;
+    }
+
+    //Transport actions go in up front, each deck runs them at its exact output sample
+    for (auto& command : commands)
+    {
+        decks.getDeck(command.first)->scheduleCommand(command.second);
+    }
+
+    std::unique_ptr<DeckRenderPool> renderPool;
+    if (numThreads > 0)
+    {
+        renderPool.reset(new DeckRenderPool(numThreads));
+        //Offline there is no deadline worth dropping a deck for
+        mixer.setRenderDeadline(0);
+        mixer.setRenderPool(renderPool.get());
+    }
+
+    outputFile.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(outputFile.createOutputStream());
+    if (stream == nullptr)
+    {
+        return "Could not write " + outputFile.getFullPathName();
+    }
+
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(stream.get(), sampleRate, 2, bitDepth, {}, 0));
+    if (writer == nullptr)
+    {
+        return "Could not write a " + juce::String(bitDepth) + " bit WAV file.";
+    }
+    //The writer owns the stream now
+    stream.release();
+
+    AudioProfiler::nameThread("Offline render");
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    auto totalSamples = (juce::int64) std::llround(lengthInSeconds * sampleRate);
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (juce::int64 position = 0; position < totalSamples; position += blockSize)
+    {
+        int numSamples = (int) juce::jmin((juce::int64) blockSize, totalSamples - position);
+
+        applyRamps((double) position / sampleRate);
+        mixer.getNextAudioBlock(juce::AudioSourceChannelInfo(&buffer, 0, numSamples));
+        {
+            OTODESKS_PROFILE_SCOPE("SessionRenderer::write");
+            writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+        }
+
+        //No message loop here, hand the transport events over by hand
+        for (int i = 0; i < decks.getNumDecks(); ++i)
+        {
+            decks.getDeck(i)->dispatchTransportEvents();
+        }
+    }
+
+    writer.reset();
+    mixer.setRenderPool(nullptr);
+    mixer.releaseResources();
+
+    double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    std::cout << "SessionRenderer::render " << lengthInSeconds << " s of audio in " << seconds << " s ("
+              << lengthInSeconds / juce::jmax(seconds, 0.001) << "x real time), headroom "
+              << mixer.getHeadroomDb() << " dB, clipped blocks " << mixer.getNumClips() << std::endl;
+    return {};
+}
+
+void SessionRenderer::applyRamps(double time)
+{
+    for (auto& ramp : ramps)
+    {
+        if (ramp.startTime > time)   //Sorted, nothing else has started
+        {
+            break;
+        }
+
+        if (!ramp.started)
+        {
+            ramp.started = true;
+            ramp.from = getValue(ramp.deck, ramp.parameter);
+
+            if (ramp.filter.isNotEmpty())
+            {
+                auto& state = deckStates[(size_t) ramp.deck];
+                state.lowPass = ramp.filter == "lowPass";
+                state.highPass = ramp.filter == "highPass";
+                state.bandPass = ramp.filter == "bandPass";
+                state.filtering = true;
+                decks.getDeck(ramp.deck)->setPass(state.cutOff, state.Q, state.lowPass, state.highPass, state.bandPass);
+            }
+        }
+
+        double progress = ramp.length > 0 ? juce::jlimit(0.0, 1.0, (time - ramp.startTime) / ramp.length) : 1.0;
+        setValue(ramp.deck, ramp.parameter, ramp.from + (ramp.to - ramp.from) * progress);
+    }
+}
+
+double SessionRenderer::getValue(int deck, Parameter parameter) const
+{
+    if (parameter == crossfaderParameter)
+    {
+        return crossfader;
+    }
+    if (parameter == masterParameter)
+    {
+        return master;
+    }
+
+    auto& state = deckStates[(size_t) deck];
+    switch (parameter)
+    {
+        case gainParameter:   return state.gain;
+        case speedParameter:  return state.speed;
+        case cutOffParameter: return state.cutOff;
+        case QParameter:      return state.Q;
+        case eqLowParameter:  return state.eqLow;
+        case eqMidParameter:  return state.eqMid;
+        case eqHighParameter: return state.eqHigh;
+        case faderParameter:  return state.fader;
+        default:              return 0;
+    }
+}
+
+void SessionRenderer::setValue(int deck, Parameter parameter, double value)
+{
+    if (parameter == crossfaderParameter)
+    {
+        crossfader = value;
+        mixer.setCrossfader((float) value);
+        return;
+    }
+    if (parameter == masterParameter)
+    {
+        master = value;
+        mixer.setMasterGain((float) value);
+        return;
+    }
+
+    auto& state = deckStates[(size_t) deck];
+    auto* player = decks.getDeck(deck);
+
+    switch (parameter)
+    {
+        case gainParameter:
+            state.gain = value;
+            player->setGain(value);
+            break;
+        case speedParameter:
+            state.speed = value;
+            player->setSpeed(value);
+            break;
+        case cutOffParameter:
+            state.cutOff = value;
+            state.filtering = true;
+            break;
+        case QParameter:
+            state.Q = value;
+            state.filtering = true;
+            break;
+        case eqLowParameter:
+            state.eqLow = value;
+            player->setEQ(state.eqLow, state.eqMid, state.eqHigh);
+            break;
+        case eqMidParameter:
+            state.eqMid = value;
+            player->setEQ(state.eqLow, state.eqMid, state.eqHigh);
+            break;
+        case eqHighParameter:
+            state.eqHigh = value;
+            player->setEQ(state.eqLow, state.eqMid, state.eqHigh);
+            break;
+        case faderParameter:
+            state.fader = value;
+            mixer.setFader(decks.getChannel(deck), (float) value);
+            break;
+        default:
+            break;
+    }
+
+    if (state.filtering && (parameter == cutOffParameter || parameter == QParameter))
+    {
+        player->setPass(state.cutOff, state.Q, state.lowPass, state.highPass, state.bandPass);
+    }
+}
+
+bool SessionRenderer::parseParameter(const juce::String& name, Parameter& parameter)
+{
+    if (name == "gain")            parameter = gainParameter;
+    else if (name == "speed")      parameter = speedParameter;
+    else if (name == "cutOff")     parameter = cutOffParameter;
+    else if (name == "Q")          parameter = QParameter;
+    else if (name == "eqLow")      parameter = eqLowParameter;
+    else if (name == "eqMid")      parameter = eqMidParameter;
+    else if (name == "eqHigh")     parameter = eqHighParameter;
+    else if (name == "fader")      parameter = faderParameter;
+    else if (name == "crossfader") parameter = crossfaderParameter;
+    else if (name == "master")     parameter = masterParameter;
+    else                           return false;
+
+    return true;
+}
+
+double SessionRenderer::getLengthInSeconds() const
+{
+    return lengthInSeconds;
+}
+
+double SessionRenderer::getSampleRate() const
+{
+    return sampleRate;
+}
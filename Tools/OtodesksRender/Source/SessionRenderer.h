@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    SessionRenderer.h
+    Created: 21 Sep 2022 4:12:50pm
+    Author:  Api Rich
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Engine/DeckMixer.h"
+#include "Engine/DeckRegistry.h"
+#include "Engine/DeckRenderPool.h"
+#include "Engine/AudioProfiler.h"
+
+//==============================================================================
+/*
+    Renders a scripted session offline, as fast as the CPU allows.
+
+    A session is a JSON file:
+
+    {
+        "sampleRate": 44100,
+        "blockSize": 256,
+        "length": 120,
+        "bitDepth": 24,
+        "quality": "high",
+        "decks": [ { "track": "intro.wav", "side": "A" },
+                   { "track": "next.wav", "side": "B", "looping": false, "keyLock": true, "bpm": 126 } ],
+        "events": [ { "time": 0, "deck": 0, "do": "play" },
+                    { "time": 20, "deck": 0, "set": "speed", "to": 1.05, "ramp": 4 },
+                    { "time": 28, "deck": 0, "filter": "highPass", "set": "cutOff", "to": 400, "ramp": 6 },
+                    { "time": 30, "deck": 1, "do": "play" },
+                    { "time": 30, "set": "crossfader", "to": 1, "ramp": 8 },
+                    { "time": 40, "deck": 0, "do": "stop" } ] }
+
+    Track paths are relative to the session file. Actions ("do": play, stop,
+    cue, setCue and jump with "position" in secs, loopIn, loopOut, reloop,
+    exitLoop and beatLoop with "beats" at the deck's "bpm") run at their
+    exact sample, loops wrap at their exact sample too.
+    Parameters ("set": gain, speed, cutOff, Q, eqLow, eqMid, eqHigh and fader on
+    a deck, crossfader and master on the mixer) move linearly over "ramp" secs,
+    updated every block.
+    The resampling "quality" (low, medium or high) defaults to high offline,
+    where there is no deadline to meet.
+*/
+class SessionRenderer
+{
+public:
+    SessionRenderer();
+    ~SessionRenderer();
+
+    //Read a session file, returns an error message (empty when it is fine)
+    juce::String loadSession(const juce::File& sessionFile);
+
+    //Render the session into a WAV file with numThreads render workers, returns an error message (empty when it is fine)
+    juce::String render(const juce::File& outputFile, int numThreads);
+
+    double getLengthInSeconds() const;
+    double getSampleRate() const;
+
+private:
+    //Deck or mixer parameter that can be automated
+    enum Parameter
+    {
+        gainParameter = 0,
+        speedParameter,
+        cutOffParameter,
+        QParameter,
+        eqLowParameter,
+        eqMidParameter,
+        eqHighParameter,
+        faderParameter,
+        crossfaderParameter,
+        masterParameter
+    };
+
+    struct DeckSetup
+    {
+        juce::File track;
+        DeckMixer::Side side = DeckMixer::thru;
+        bool looping = false;
+        bool keyLock = false;
+        double bpm = 120.0;
+    };
+
+    //Parameters of a deck as the script has left them
+    struct DeckState
+    {
+        double gain = 1.0;
+        double speed = 1.0;
+        double cutOff = 20000.0;
+        double Q = 0.7;
+        double eqLow = 1.0;
+        double eqMid = 1.0;
+        double eqHigh = 1.0;
+        double fader = 1.0;
+        bool lowPass = false;
+        bool highPass = false;
+        bool bandPass = false;
+        bool filtering = false;
+    };
+
+    struct Ramp
+    {
+        double startTime = 0;
+        double length = 0;
+        int deck = -1;
+        Parameter parameter = gainParameter;
+        double to = 0;
+        //Filter mode switched at the start of the ramp, empty to keep the current one
+        juce::String filter;
+        //Captured when the ramp starts
+        double from = 0;
+        bool started = false;
+    };
+
+    //Load every deck of the session and wait until it is ready
+    juce::String loadDecks();
+    //Apply the ramps that are running at time (in secs)
+    void applyRamps(double time);
+    double getValue(int deck, Parameter parameter) const;
+    void setValue(int deck, Parameter parameter, double value);
+    static bool parseParameter(const juce::String& name, Parameter& parameter);
+
+    double sampleRate = 44100.0;
+    int blockSize = 256;
+    double lengthInSeconds = 0;
+    int bitDepth = 24;
+    std::vector<DeckSetup> deckSetups;
+    std::vector<DeckState> deckStates;
+    std::vector<Ramp> ramps;
+    std::vector<std::pair<int, DeckTransport::Command>> commands;
+    double crossfader = 0.5;
+    double master = 1.0;
+
+    //The engine, the same one the app plays through
+    juce::AudioFormatManager formatManager;
+    juce::TimeSliceThread readAheadThread{ "Offline read-ahead" };
+    DecodedTrackCache trackCache{ formatManager, (size_t) 2048 * 1024 * 1024 };
+    DeckMixer mixer;
+    DeckRegistry decks{ formatManager, readAheadThread, trackCache, mixer };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionRenderer)
+};